@@ -70,7 +70,29 @@ SOURCES += src/main.cpp \
     src/exporters/simpleexporter.cpp \
     src/layouters/boxlayouteroptimized.cpp \
     src/exporters/myguiexporter.cpp \
-    src/exporters/bmfontexporter.cpp
+    src/exporters/bmfontexporter.cpp \
+    src/exporters/bmfontbinaryexporter.cpp \
+    src/exporters/xmlwriter.cpp \
+    src/exporters/textwriter.cpp \
+    src/exporters/runtimeexporter.cpp \
+    src/exportjob.cpp \
+    src/atomicfile.cpp \
+    src/kerningclasses.cpp \
+    src/abstractreader.cpp \
+    src/readerfactory.cpp \
+    src/readers/ghlreader.cpp \
+    src/readers/bmfontreader.cpp \
+    src/readers/simplereader.cpp \
+    src/readers/zfireader.cpp \
+    src/readers/luareader.cpp \
+    src/fontdatabasecache.cpp \
+    src/fontfile.cpp \
+    src/batchbuilder.cpp \
+    src/rendercache.cpp \
+    src/projectfile.cpp \
+    src/rebuildscheduler.cpp \
+    src/perf.cpp \
+    src/perfdialog.cpp
 
 HEADERS += src/fontbuilder.h \
     src/colorbutton.h \
@@ -111,7 +133,30 @@ HEADERS += src/fontbuilder.h \
     src/exporters/simpleexporter.h \
     src/layouters/boxlayouteroptimized.h \
     src/exporters/myguiexporter.h \
-    src/exporters/bmfontexporter.h
+    src/exporters/bmfontexporter.h \
+    src/exporters/bmfontbinaryexporter.h \
+    src/exporters/xmlwriter.h \
+    src/exporters/textwriter.h \
+    src/exporters/runtimeexporter.h \
+    src/exporters/fbruntime.h \
+    src/exportjob.h \
+    src/atomicfile.h \
+    src/kerningclasses.h \
+    src/abstractreader.h \
+    src/readerfactory.h \
+    src/readers/ghlreader.h \
+    src/readers/bmfontreader.h \
+    src/readers/simplereader.h \
+    src/readers/zfireader.h \
+    src/readers/luareader.h \
+    src/fontdatabasecache.h \
+    src/fontfile.h \
+    src/batchbuilder.h \
+    src/rendercache.h \
+    src/projectfile.h \
+    src/rebuildscheduler.h \
+    src/perf.h \
+    src/perfdialog.h
 
 FORMS += src/fontbuilder.ui \
     src/fontselectframe.ui \
@@ -120,14 +165,15 @@ FORMS += src/fontbuilder.ui \
     src/layoutconfigframe.ui \
     src/outputframe.ui \
     src/fonttestframe.ui \
-    src/charmapdialog.ui
+    src/charmapdialog.ui \
+    src/perfdialog.ui
 TRANSLATIONS = fontbuilder_en.ts \
     fontbuilder_ru.ts
 
 QT += xml
 
 greaterThan(QT_MAJOR_VERSION, 4) {
-    QT += widgets
+    QT += widgets concurrent
 }
 
 DESTDIR = bin
@@ -137,30 +183,6 @@ UI_DIR = .obj
 TARGET = FontBuilder
 
 INCLUDEPATH+=src/
-FREETYPE2CONFIG = $$(FREETYPE2CONFIG)
-isEmpty(FREETYPE2CONFIG) {
-    mac {
-        INCLUDEPATH += ../include
-        INCLUDEPATH += ../include/freetype2
-        LIBS += -L../lib -lfreetype -lz
-    # macports support
-        INCLUDEPATH += /opt/local/include /opt/local/include/freetype2
-        LIBS += -L/opt/local/lib
-    }
-    win32 {
-        INCLUDEPATH += ../include
-        INCLUDEPATH += ../include/freetype2
-        LIBS += -L../lib \
-            -lfreetype
-    }
-    linux*|freebsd* {
-        CONFIG += link_pkgconfig
-        PKGCONFIG += freetype2
-    }
-} else {
-    message("configured freetype2 config: $$FREETYPE2CONFIG" )
-    INCLUDEPATH+=$$system("$$FREETYPE2CONFIG --prefix")/include/freetype2
-    LIBS += $$system("$$FREETYPE2CONFIG --libs")
-}
+include(freetype.pri)
 OTHER_FILES += fontbuilder_ru.ts \
     fontbuilder_en.ts
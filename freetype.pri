@@ -0,0 +1,55 @@
+# /**
+# * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+# * email:support.andryblack@gmail.com
+# *
+# * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+# *
+# * This software is distributed under the MIT License.
+# *
+# * Permission is hereby granted, free of charge, to any person
+# * obtaining a copy of this software and associated documentation
+# * files (the "Software"), to deal in the Software without
+# * restriction, including without limitation the rights to use,
+# * copy, modify, merge, publish, distribute, sublicense, and/or sell
+# * copies of the Software, and to permit persons to whom the
+# * Software is furnished to do so, subject to the following
+# * conditions:
+# *
+# * The above copyright notice and this permission notice shall be
+# * included in all copies or substantial portions of the Software.
+# *
+# * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+# * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+# * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+# * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+# * OTHER DEALINGS IN THE SOFTWARE.
+# */
+# FreeType 2, shared by the application and the benchmarks
+FREETYPE2CONFIG = $$(FREETYPE2CONFIG)
+isEmpty(FREETYPE2CONFIG) {
+    mac {
+        INCLUDEPATH += $$PWD/../include
+        INCLUDEPATH += $$PWD/../include/freetype2
+        LIBS += -L$$PWD/../lib -lfreetype -lz
+    # macports support
+        INCLUDEPATH += /opt/local/include /opt/local/include/freetype2
+        LIBS += -L/opt/local/lib
+    }
+    win32 {
+        INCLUDEPATH += $$PWD/../include
+        INCLUDEPATH += $$PWD/../include/freetype2
+        LIBS += -L$$PWD/../lib \
+            -lfreetype
+    }
+    linux*|freebsd* {
+        CONFIG += link_pkgconfig
+        PKGCONFIG += freetype2
+    }
+} else {
+    message("configured freetype2 config: $$FREETYPE2CONFIG" )
+    INCLUDEPATH+=$$system("$$FREETYPE2CONFIG --prefix")/include/freetype2
+    LIBS += $$system("$$FREETYPE2CONFIG --libs")
+}
@@ -33,6 +33,10 @@
 #include "layoutconfig.h"
 #include "rendererdata.h"
 #include "fontconfig.h"
+#include "kerningclasses.h"
+#include "perf.h"
+
+#include <QDebug>
 
 AbstractExporter::AbstractExporter(QObject *parent) :
     QObject(parent)
@@ -42,13 +46,29 @@ AbstractExporter::AbstractExporter(QObject *parent) :
     m_tex_width = 0;
     m_tex_height = 0;
     m_scale = 1.0;
+    m_use_kerning_classes = false;
+    m_kerning_classes = 0;
+}
+
+AbstractExporter::~AbstractExporter() {
+    delete m_kerning_classes;
 }
 
 
+static bool SortSymbolsById(const AbstractExporter::Symbol& a,const AbstractExporter::Symbol& b) {
+    return a.id < b.id;
+}
+
 void AbstractExporter::setData(const LayoutData* data,const RendererData& rendered) {
     m_metrics = rendered.metrics;
     m_metrics.height+=fontConfig()->lineSpacing();
+    m_metrics.height64+=fontConfig()->lineSpacing()*64;
     m_symbols.clear();
+    m_kernings.clear();
+    delete m_kerning_classes;
+    m_kerning_classes = 0;
+    m_symbols.reserve(data->placed().size());
+    int kernings = 0;
     foreach ( const LayoutChar& lc, data->placed()) {
         Symbol symb;
         symb.id = lc.symbol;
@@ -56,20 +76,88 @@ void AbstractExporter::setData(const LayoutData* data,const RendererData& render
         symb.placeY = lc.y;
         symb.placeW = lc.w;
         symb.placeH = lc.h;
-        const RenderedChar& rc = rendered.chars[symb.id];
-        symb.offsetX = rc.offsetX-layoutConfig()->offsetLeft();
-        symb.offsetY = rc.offsetY+layoutConfig()->offsetTop();
-        symb.advance = rc.advance + fontConfig()->charSpacing();
-        symb.kerning = rc.kerning;
+        symb.offsetX = 0;
+        symb.offsetY = 0;
+        symb.advance = 0;
+        symb.advance64 = 0;
+        symb.kerningBegin = 0;
+        symb.kerningCount = 0;
+        QMap<uint,RenderedChar>::ConstIterator it = rendered.chars.constFind(symb.id);
+        if (it!=rendered.chars.constEnd()) {
+            const RenderedChar& rc = it.value();
+            symb.offsetX = rc.offsetX-layoutConfig()->offsetLeft();
+            symb.offsetY = rc.offsetY+layoutConfig()->offsetTop();
+            symb.advance = rc.advance + fontConfig()->charSpacing();
+            symb.advance64 = rc.advance64 + fontConfig()->charSpacing()*64;
+            symb.kerningCount = rc.kerning64.size();
+            kernings+=symb.kerningCount;
+        }
         m_symbols.push_back(symb);
     }
+    qSort(m_symbols.begin(),m_symbols.end(),SortSymbolsById);
+
+    // per-glyph maps are already ordered by second glyph, pairs that
+    // are zero in 26.6 are left out, pixelKernings drops the zero pixel ones
+    m_kernings.reserve(kernings);
+    typedef QMap<uint,int>::ConstIterator Kerning;
+    for (int i=0;i<m_symbols.size();i++) {
+        Symbol& symb = m_symbols[i];
+        symb.kerningBegin = m_kernings.size();
+        if (!symb.kerningCount)
+            continue;
+        const RenderedChar& rc = rendered.chars.constFind(symb.id).value();
+        for (Kerning k = rc.kerning64.begin();k!=rc.kerning64.end();k++) {
+            KerningPair pair;
+            pair.first = symb.id;
+            pair.second = k.key();
+            pair.amount = rc.kerning.value(k.key());
+            pair.amount64 = k.value();
+            if (pair.amount64!=0)
+                m_kernings.push_back(pair);
+        }
+        symb.kerningCount = m_kernings.size()-symb.kerningBegin;
+    }
     m_tex_width = data->width();
     m_tex_height = data->height();
 }
 
 
+void AbstractExporter::copyData(const AbstractExporter* other) {
+    m_metrics = other->m_metrics;
+    m_symbols = other->m_symbols;
+    m_kernings = other->m_kernings;
+    m_tex_width = other->m_tex_width;
+    m_tex_height = other->m_tex_height;
+    delete m_kerning_classes;
+    m_kerning_classes = 0;
+}
+
+QVector<AbstractExporter::KerningPair> AbstractExporter::pixelKernings() const {
+    QVector<KerningPair> pairs;
+    pairs.reserve(m_kernings.size());
+    foreach (const KerningPair& k , m_kernings)
+        if (k.amount!=0)
+            pairs.push_back(k);
+    return pairs;
+}
+
+const KerningClasses* AbstractExporter::kerningClasses() const {
+    if (!m_use_kerning_classes)
+        return 0;
+    if (!m_kerning_classes) {
+        m_kerning_classes = new KerningClasses();
+        m_kerning_classes->build(m_kernings);
+        qDebug() << "kerning classes:" << m_kerning_classes->pairCount() << "pairs ->"
+                 << m_kerning_classes->leftCount() << "x" << m_kerning_classes->rightCount()
+                 << "classes," << m_kerning_classes->tableSize() << "table entries";
+    }
+    return m_kerning_classes;
+}
+
 bool AbstractExporter::Write(QByteArray& bytes) {
+    PerfTimer timer("description export");
     if (Export(bytes)) {
+        Perf::count("bytes written",bytes.size());
        return true;
     }
     return false;
@@ -44,12 +44,14 @@
 class FontConfig;
 class LayoutConfig;
 class LayoutData;
+class KerningClasses;
 
 class AbstractExporter : public QObject
 {
 Q_OBJECT
 public:
     explicit AbstractExporter(QObject *parent );
+    ~AbstractExporter();
 
     const QString& getErrorString() const { return m_error_string;}
     const QString& getExtension() const { return m_extension;}
@@ -57,10 +59,42 @@ public:
     bool Write(QByteArray& out);
 
     void setFace(FT_Face face) { m_face = face; }
+    /// formats that read the face given to setFace, others get none
+    virtual bool needsFace() const { return false; }
     void setFontConfig(const FontConfig* config,const LayoutConfig* layout) { m_font_config = config;m_layout_config=layout;}
     void setData(const LayoutData* data,const RendererData& rendered);
+    /// share the symbol table another exporter built with setData
+    void copyData(const AbstractExporter* other);
     void setTextureFilename(const QString& fn) { m_texture_file = fn;}
     void setScale(float scale) { m_scale = scale; }
+    /// write a class matrix instead of kerning pairs, if the format can
+    void setKerningClasses(bool use) { m_use_kerning_classes = use; }
+
+    /// kerning between two glyphs, ordered by (first, second)
+    struct KerningPair {
+        uint first;
+        uint second;
+        int amount;         ///< grid fitted pixels
+        int amount64;       ///< unfitted 26.6
+    };
+    /// placed glyph, ordered by id
+    struct Symbol {
+        uint id;
+        int placeX;
+        int placeY;
+        int placeW;
+        int placeH;
+        int offsetX;
+        int offsetY;
+        int advance;
+        int advance64;      ///< 26.6, advance is it truncated
+        int kerningBegin;   ///< first pair in kernings() with this glyph as first
+        int kerningCount;
+    };
+    const QVector<Symbol>& symbols() const { return m_symbols;}
+    const QVector<KerningPair>& kernings() const { return m_kernings;}
+    /// kernings() without the pairs that fit to zero pixels, for integer formats
+    QVector<KerningPair> pixelKernings() const;
 private:
     QString m_error_string;
     QString m_extension;
@@ -73,21 +107,10 @@ private:
     FT_Face m_face;
     float   m_scale;
 protected:
-    struct Symbol {
-        uint id;
-        int placeX;
-        int placeY;
-        int placeW;
-        int placeH;
-        int offsetX;
-        int offsetY;
-        int advance;
-        QMap<uint,int> kerning;
-    };
-
     const FontConfig* fontConfig() const { return m_font_config;}
     const LayoutConfig* layoutConfig() const { return m_layout_config;}
-    const QVector<Symbol>& symbols() const { return m_symbols;}
+    const KerningPair* kerningBegin(const Symbol& s) const { return m_kernings.constData()+s.kerningBegin;}
+    const KerningPair* kerningEnd(const Symbol& s) const { return kerningBegin(s)+s.kerningCount;}
     void setExtension(const QString& extension) { m_extension = extension;}
     void setErrorMessage(const QString& str) { m_error_string=str; }
     int texWidth() const { return m_tex_width;}
@@ -98,8 +121,13 @@ protected:
     virtual bool Export(QByteArray& out) = 0;
     FT_Face face() const {return m_face;}
     float scale() const { return m_scale; }
+    /// class form of kernings(), 0 if not requested
+    const KerningClasses* kerningClasses() const;
 private:
      QVector<Symbol> m_symbols;
+     QVector<KerningPair> m_kernings;
+     bool m_use_kerning_classes;
+     mutable KerningClasses* m_kerning_classes;
 };
 
 
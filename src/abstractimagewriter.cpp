@@ -31,6 +31,7 @@
 #include "abstractimagewriter.h"
 #include "layoutdata.h"
 #include "layoutconfig.h"
+#include "perf.h"
 
 #include <QPainter>
 #include <QFileSystemWatcher>
@@ -65,7 +66,12 @@ static void placeImage(QImage& dst,int x,int y,const QImage& src) {
 }
 
 QImage AbstractImageWriter::buildImage() {
-    QImage pixmap(layout()->width(),layout()->height(),QImage::Format_ARGB32);
+    return buildImage(layout(),layoutConfig(),*rendered());
+}
+
+QImage AbstractImageWriter::buildImage(const LayoutData* layout,const LayoutConfig* config,const RendererData& rendered) {
+    PerfTimer timer("composite");
+    QImage pixmap(layout->width(),layout->height(),QImage::Format_ARGB32);
 
     pixmap.fill(0x00ffffff);
 
@@ -83,18 +89,26 @@ QImage AbstractImageWriter::buildImage() {
                               c.y + layoutConfig()->offsetTop(),rend.img);
         }
     */
-    foreach (const LayoutChar& c,layout()->placed())
-            if (rendered()->chars.contains(c.symbol)) {
-                const RenderedChar& rend = rendered()->chars[c.symbol];
-                int x = c.x + layoutConfig()->offsetLeft();
-                int y = c.y + layoutConfig()->offsetTop();
-                placeImage(pixmap,x,y,rend.img);
-            }
+    foreach (const LayoutChar& c,layout->placed()) {
+        QMap<uint,RenderedChar>::const_iterator rend = rendered.chars.constFind(c.symbol);
+        if (rend!=rendered.chars.constEnd()) {
+            int x = c.x + config->offsetLeft();
+            int y = c.y + config->offsetTop();
+            placeImage(pixmap,x,y,rend->img);
+        }
+    }
     return pixmap;
 }
 
 bool AbstractImageWriter::Write(QFile& file) {
-    if (Export(file)) {
+    QImage pixmap = buildImage();
+    return Write(file,AtlasView(pixmap));
+}
+
+bool AbstractImageWriter::Write(QFile& file,const AtlasView& atlas) {
+    PerfTimer timer("image export");
+    if (Export(file,atlas)) {
+        Perf::count("bytes written",file.size());
        return true;
     }
     return false;
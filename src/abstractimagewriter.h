@@ -46,6 +46,22 @@ class LayoutConfig;
 class QFileSystemWatcher;
 class QTimer;
 
+/// Read-only view of an already composited atlas. Does not own the pixels,
+/// the buffer must outlive the write.
+struct AtlasView {
+    const uchar* data;
+    int width;
+    int height;
+    int stride;
+    QImage::Format format;
+    AtlasView() : data(0),width(0),height(0),stride(0),format(QImage::Format_Invalid) {}
+    AtlasView(const uchar* data,int width,int height,int stride,QImage::Format format) :
+            data(data),width(width),height(height),stride(stride),format(format) {}
+    explicit AtlasView(const QImage& image) :
+            data(image.constBits()),width(image.width()),height(image.height()),
+            stride(image.bytesPerLine()),format(image.format()) {}
+};
+
 class AbstractImageWriter : public QObject
 {
 Q_OBJECT
@@ -56,9 +72,11 @@ public:
     const QString& extension() const { return m_extension;}
 
     bool Write(QFile& file);
+    bool Write(QFile& file,const AtlasView& atlas);
     QImage* Read(QFile& file);
 
     void setData(const LayoutData* data,const LayoutConfig* config,const RendererData& rendered);
+    static QImage buildImage(const LayoutData* layout,const LayoutConfig* config,const RendererData& rendered);
 
     void forget();
     void watch(const QString& file);
@@ -85,7 +103,7 @@ protected:
     const RendererData* rendered() const { return m_rendered;}
     const LayoutData* layout() const { return m_layout;}
     const LayoutConfig* layoutConfig() const { return m_layout_config;}
-    virtual bool Export(QFile& file) = 0;
+    virtual bool Export(QFile& file,const AtlasView& atlas) = 0;
     virtual QImage* reload( QFile& file) { Q_UNUSED(file);return 0;}
     QImage buildImage();
 protected slots:
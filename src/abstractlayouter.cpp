@@ -31,6 +31,7 @@
 #include "abstractlayouter.h"
 #include "layoutdata.h"
 #include "layoutconfig.h"
+#include "perf.h"
 
 AbstractLayouter::AbstractLayouter(QObject *parent) :
     QObject(parent)
@@ -73,6 +74,8 @@ void AbstractLayouter::on_ReplaceImages(const QVector<LayoutChar>& chars) {
 
 void AbstractLayouter::on_LayoutDataChanged() {
     if (m_data!=0 && m_config!=0 ) {
+        PerfTimer timer("layout");
+        Perf::count("placement passes");
         QVector<LayoutChar> chars = m_chars;
         {
             for( int i=0;i<m_chars.size();i++) {
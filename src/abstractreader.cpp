@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "abstractreader.h"
+
+#include <QtAlgorithms>
+
+AbstractReader::AbstractReader(QObject *parent) :
+    QObject(parent)
+{
+    m_fields = AllFields;
+    m_size = 0;
+    m_line_height = 0;
+    m_ascender = 0;
+    m_tex_width = 0;
+    m_tex_height = 0;
+}
+
+static bool SortSymbolsById(const AbstractReader::Symbol& a,const AbstractReader::Symbol& b) {
+    return a.id < b.id;
+}
+
+static bool SortKernings(const AbstractReader::KerningPair& a,const AbstractReader::KerningPair& b) {
+    return a.first < b.first || (a.first==b.first && a.second < b.second);
+}
+
+bool AbstractReader::Read(const QByteArray& data) {
+    m_error_string.clear();
+    m_symbols.clear();
+    m_kernings.clear();
+    m_family.clear();
+    m_texture_file.clear();
+    m_size = m_line_height = m_ascender = 0;
+    m_tex_width = m_tex_height = 0;
+    if (!Import(data))
+        return false;
+
+    qSort(m_symbols.begin(),m_symbols.end(),SortSymbolsById);
+    qSort(m_kernings.begin(),m_kernings.end(),SortKernings);
+    int k = 0;
+    for (int i=0;i<m_symbols.size();i++) {
+        Symbol& symb = m_symbols[i];
+        while (k<m_kernings.size() && m_kernings[k].first<symb.id)
+            k++;
+        symb.kerningBegin = k;
+        while (k<m_kernings.size() && m_kernings[k].first==symb.id)
+            k++;
+        symb.kerningCount = k-symb.kerningBegin;
+        // text formats carry whole pixels only
+        symb.advance64 = symb.advance*64;
+    }
+    return true;
+}
+
+AbstractReader::Symbol& AbstractReader::addSymbol(uint id) {
+    Symbol symb;
+    symb.id = id;
+    symb.placeX = symb.placeY = symb.placeW = symb.placeH = 0;
+    symb.offsetX = symb.offsetY = symb.advance = 0;
+    symb.advance64 = 0;
+    symb.kerningBegin = symb.kerningCount = 0;
+    m_symbols.push_back(symb);
+    return m_symbols.back();
+}
+
+void AbstractReader::addKerning(uint first,uint second,int amount) {
+    KerningPair pair;
+    pair.first = first;
+    pair.second = second;
+    pair.amount = amount;
+    pair.amount64 = amount*64;
+    m_kernings.push_back(pair);
+}
+
+bool AbstractReader::toInt(const char* begin,const char* end,int& value) {
+    bool negative = false;
+    if (begin<end && (*begin=='-' || *begin=='+')) {
+        negative = *begin=='-';
+        begin++;
+    }
+    if (begin>=end)
+        return false;
+    qint64 result = 0;
+    for (;begin<end;begin++) {
+        if (*begin<'0' || *begin>'9')
+            return false;
+        result = result*10 + (*begin-'0');
+        if (result > Q_INT64_C(0xffffffff))
+            return false;
+    }
+    value = int(negative ? -result : result);
+    return true;
+}
+
+QStringList AbstractReader::compare(const QVector<Symbol>& symbols,const QVector<KerningPair>& kernings) const {
+    const int max_messages = 20;
+    QStringList messages;
+    int count = 0;
+#define REPORT(text) do { if (count++<max_messages) messages.push_back(text);} while (0)
+#define CHECK(field) do { if (a.field!=b.field) \
+        REPORT(QString("char %1: " #field " %2, read %3").arg(a.id).arg(a.field).arg(b.field));} while (0)
+
+    int i = 0, j = 0;
+    while (i<symbols.size() || j<m_symbols.size()) {
+        if (j>=m_symbols.size() || (i<symbols.size() && symbols[i].id<m_symbols[j].id)) {
+            REPORT(QString("char %1 missing").arg(symbols[i].id));
+            i++;
+            continue;
+        }
+        if (i>=symbols.size() || m_symbols[j].id<symbols[i].id) {
+            REPORT(QString("char %1 unexpected").arg(m_symbols[j].id));
+            j++;
+            continue;
+        }
+        const Symbol& a = symbols[i++];
+        const Symbol& b = m_symbols[j++];
+        if (m_fields & Placement) {
+            CHECK(placeX);
+            CHECK(placeY);
+            CHECK(placeW);
+            CHECK(placeH);
+        }
+        if (m_fields & Offsets) {
+            CHECK(offsetX);
+            CHECK(offsetY);
+        }
+        if (m_fields & Advance) {
+            CHECK(advance);
+        }
+    }
+
+    if (m_fields & Kerning) {
+        i = j = 0;
+        while (i<kernings.size() || j<m_kernings.size()) {
+            if (j>=m_kernings.size() || (i<kernings.size() && SortKernings(kernings[i],m_kernings[j]))) {
+                REPORT(QString("kerning %1 %2 missing").arg(kernings[i].first).arg(kernings[i].second));
+                i++;
+                continue;
+            }
+            if (i>=kernings.size() || SortKernings(m_kernings[j],kernings[i])) {
+                REPORT(QString("kerning %1 %2 unexpected").arg(m_kernings[j].first).arg(m_kernings[j].second));
+                j++;
+                continue;
+            }
+            if (kernings[i].amount!=m_kernings[j].amount)
+                REPORT(QString("kerning %1 %2: amount %3, read %4").arg(kernings[i].first).arg(kernings[i].second)
+                       .arg(kernings[i].amount).arg(m_kernings[j].amount));
+            i++;
+            j++;
+        }
+    }
+#undef CHECK
+#undef REPORT
+    if (count>max_messages)
+        messages.push_back(QString("... %1 more differences").arg(count-max_messages));
+    return messages;
+}
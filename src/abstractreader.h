@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ABSTRACTREADER_H
+#define ABSTRACTREADER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+#include "abstractexporter.h"
+
+/// Parses a description written by an exporter back into the exporter
+/// symbol model, to check exporters and to load exported fonts.
+class AbstractReader : public QObject
+{
+Q_OBJECT
+public:
+    typedef AbstractExporter::Symbol Symbol;
+    typedef AbstractExporter::KerningPair KerningPair;
+
+    /// data a format carries, compare() checks only these
+    enum Field {
+        Placement = 1,
+        Offsets = 2,
+        Advance = 4,
+        Kerning = 8,
+        AllFields = Placement|Offsets|Advance|Kerning
+    };
+
+    explicit AbstractReader(QObject *parent);
+
+    bool Read(const QByteArray& data);
+    const QString& errorString() const { return m_error_string;}
+    int fields() const { return m_fields;}
+
+    /// sorted like the exporter tables
+    const QVector<Symbol>& symbols() const { return m_symbols;}
+    const QVector<KerningPair>& kernings() const { return m_kernings;}
+
+    const QString& family() const { return m_family;}
+    int size() const { return m_size;}
+    int lineHeight() const { return m_line_height;}
+    int ascender() const { return m_ascender;}
+    const QString& texFilename() const { return m_texture_file;}
+    int texWidth() const { return m_tex_width;}
+    int texHeight() const { return m_tex_height;}
+
+    /// differences to the tables an exporter wrote, empty if equivalent
+    QStringList compare(const QVector<Symbol>& symbols,const QVector<KerningPair>& kernings) const;
+
+    /// parses a decimal integer from the bytes, false if there is none
+    static bool toInt(const char* begin,const char* end,int& value);
+protected:
+    virtual bool Import(const QByteArray& data) = 0;
+
+    void setFields(int fields) { m_fields = fields;}
+    void setErrorMessage(const QString& str) { m_error_string = str;}
+    void setFamily(const QString& family) { m_family = family;}
+    void setSize(int size) { m_size = size;}
+    void setLineHeight(int height) { m_line_height = height;}
+    void setAscender(int ascender) { m_ascender = ascender;}
+    void setTexture(const QString& file) { m_texture_file = file;}
+    void setTextureSize(int width,int height) { m_tex_width = width; m_tex_height = height;}
+    Symbol& addSymbol(uint id);
+    QVector<Symbol>& editSymbols() { return m_symbols;}
+    void addKerning(uint first,uint second,int amount);
+private:
+    QString m_error_string;
+    int m_fields;
+    QVector<Symbol> m_symbols;
+    QVector<KerningPair> m_kernings;
+    QString m_family;
+    int m_size;
+    int m_line_height;
+    int m_ascender;
+    QString m_texture_file;
+    int m_tex_width;
+    int m_tex_height;
+};
+
+#endif // ABSTRACTREADER_H
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "atomicfile.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QDir>
+#include <QAtomicInt>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#endif
+
+/// parallel jobs of one process may write the same target
+static QAtomicInt tempCounter(0);
+
+AtomicFile::AtomicFile(const QString& name,QObject *parent) :
+    QFile(parent), m_target(name), m_committed(false)
+{
+    setFileName(QString("%1.%2.%3.tmp").arg(name)
+                .arg(QCoreApplication::applicationPid())
+                .arg(tempCounter.fetchAndAddOrdered(1)));
+}
+
+AtomicFile::~AtomicFile() {
+    discard();
+}
+
+bool AtomicFile::open(OpenMode mode) {
+    if (!(mode & WriteOnly))
+        return false;
+    m_committed = false;
+    return QFile::open(ReadWrite | Truncate | (mode & Text));
+}
+
+#ifdef Q_OS_WIN
+/// QFile::handle() is -1 for files opened by name, so the closed file
+/// is opened again natively to flush it
+static bool syncToDisk(const QString& name) {
+    HANDLE file = ::CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(name).utf16()),
+                                GENERIC_WRITE,FILE_SHARE_READ|FILE_SHARE_WRITE,0,
+                                OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,0);
+    if (file==INVALID_HANDLE_VALUE)
+        return false;
+    bool ok = ::FlushFileBuffers(file)!=0;
+    ::CloseHandle(file);
+    return ok;
+}
+#else
+static bool syncToDisk(int fd) {
+    if (fd==-1)
+        return false;
+    return ::fsync(fd)==0;
+}
+#endif
+
+static bool replaceFile(const QString& from,const QString& to) {
+#ifdef Q_OS_WIN
+    return ::MoveFileExW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(from).utf16()),
+                         reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(to).utf16()),
+                         MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)!=0;
+#else
+    if (::rename(QFile::encodeName(from).constData(),QFile::encodeName(to).constData())!=0)
+        return false;
+    /// make the rename itself durable
+    int dir = ::open(QFile::encodeName(QFileInfo(to).absolutePath()).constData(),O_RDONLY);
+    if (dir!=-1) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+    return true;
+#endif
+}
+
+bool AtomicFile::commit() {
+    if (!isOpen())
+        return false;
+#ifdef Q_OS_WIN
+    bool ok = flush();
+    close();
+    ok = ok && syncToDisk(fileName());
+#else
+    bool ok = flush() && syncToDisk(handle());
+    close();
+#endif
+    if (!ok) {
+        setErrorString(tr("Failed to flush file"));
+        discard();
+        return false;
+    }
+    if (!replaceFile(fileName(),m_target)) {
+        setErrorString(tr("Failed to replace file %1").arg(m_target));
+        discard();
+        return false;
+    }
+    m_committed = true;
+    return true;
+}
+
+void AtomicFile::discard() {
+    if (m_committed)
+        return;
+    if (isOpen())
+        close();
+    if (exists())
+        remove();
+}
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <QFile>
+
+/// Output file written to a temporary file next to the target and
+/// renamed into place by commit(). Readers never see a partially written
+/// file; an uncommitted file is removed on destruction.
+/// The temporary file is always opened read-write so writers can map() it.
+class AtomicFile : public QFile
+{
+Q_OBJECT
+public:
+    explicit AtomicFile(const QString& name,QObject *parent = 0);
+    ~AtomicFile();
+
+    const QString& targetName() const { return m_target;}
+
+    virtual bool open(OpenMode mode);
+    bool commit();
+    void discard();
+private:
+    QString m_target;
+    bool    m_committed;
+};
+
+#endif // ATOMICFILE_H
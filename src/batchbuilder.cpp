@@ -0,0 +1,564 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "batchbuilder.h"
+#include "fontconfig.h"
+#include "fontrenderer.h"
+#include "layoutconfig.h"
+#include "outputconfig.h"
+#include "layouterfactory.h"
+#include "exporterfactory.h"
+#include "imagewriterfactory.h"
+#include "readerfactory.h"
+#include "abstractexporter.h"
+#include "exportjob.h"
+#include "rendercache.h"
+#include "projectfile.h"
+#include "perf.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <cstdio>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#endif
+
+static QTextStream& out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream& err() {
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+BatchBuilder::BatchBuilder(QObject *parent) :
+    QObject(parent), m_verify(false), m_skip_unchanged(false)
+{
+    m_font_config = new FontConfig(this);
+    m_layout_config = new LayoutConfig(this);
+    m_output_config = new OutputConfig(this);
+}
+
+void BatchBuilder::usage() {
+    out() << "Usage: FontBuilder --batch [options]\n"
+             "  --project <file>              project file, other options override it\n"
+             "  --font <file>                 font file to render\n"
+             "  --face <index>                face in a font collection\n"
+             "  --size <size>                 font size\n"
+             "  --chars <file>                characters to render, utf-8 text\n"
+             "  --layouter <name>             layouter, see --list\n"
+             "  --image-format <name>         image format, may repeat\n"
+             "  --description-format <name>   description format, may repeat\n"
+             "  --output <dir>                output directory\n"
+             "  --name <name>                 base name of the output files\n"
+             "  --set <group>.<property>=<value>\n"
+             "                                any font, layout or output property\n"
+             "  --verify                      read descriptions back and compare\n"
+             "  --skip-unchanged              skip when inputs match the stored .fbhash\n"
+             "  --list                        list layouters and formats\n"
+             "  --manifest <file>             run the jobs of a JSON manifest\n"
+             "  --jobs <count>                manifest jobs run at once\n"
+             "  --perf <file>                 stage timings and counters as JSON, - for stdout\n"
+             "  --trace <file>                stage events in Chrome trace format\n"
+             "\n"
+             "A manifest is {\"defaults\": {...}, \"jobs\": [{...}, ...]}, each job\n"
+             "names the options above without dashes, e.g. \"project\", \"font\", \"size\",\n"
+             "\"description-format\" (a string or a list), flags as true, and\n"
+             "\"set\" ({\"font.bold\": 1}). Job values override the defaults.\n"
+             "Relative paths in a manifest are relative to the manifest file.\n";
+    out().flush();
+}
+
+/// characters file as the characters frame keeps it: sorted, unique
+static QString readCharacters(const QString& filename,bool* ok) {
+    QFile file(filename);
+    *ok = file.open(QFile::ReadOnly);
+    if (!*ok)
+        return QString();
+    QVector<uint> codes = QString::fromUtf8(file.readAll()).toUcs4();
+    qSort(codes.begin(),codes.end());
+    QVector<uint> unique;
+    unique.reserve(codes.size());
+    foreach (uint code, codes) {
+        if (code=='\n' || code=='\r' || code==0xfeff)
+            continue;
+        if (unique.isEmpty() || unique.back()!=code)
+            unique.push_back(code);
+    }
+    return QString::fromUcs4(unique.constData(),unique.size());
+}
+
+bool BatchBuilder::setProperty(const QString& assignment) {
+    int dot = assignment.indexOf('.');
+    int eq = assignment.indexOf('=');
+    if (dot<0 || eq<dot) {
+        err() << "invalid --set " << assignment << "\n";
+        return false;
+    }
+    QString group = assignment.left(dot);
+    QString name = assignment.mid(dot+1,eq-dot-1);
+    QString value = assignment.mid(eq+1);
+    QObject* object = 0;
+    if (group=="font" || group=="fontconfig") object = m_font_config;
+    else if (group=="layout" || group=="layoutconfig") object = m_layout_config;
+    else if (group=="output" || group=="outputconfig") object = m_output_config;
+    if (!object) {
+        err() << "unknown group " << group << "\n";
+        return false;
+    }
+    const QByteArray key = name.toLatin1();
+    if (object->metaObject()->indexOfProperty(key.constData())<0) {
+        err() << "unknown property " << group << "." << name << "\n";
+        return false;
+    }
+    QVariant variant = value;
+    if (object->property(key.constData()).type()==QVariant::StringList)
+        variant = value.split(',',QString::SkipEmptyParts);
+    if (!object->setProperty(key.constData(),variant)) {
+        err() << "invalid value for " << group << "." << name << ": " << value << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool BatchBuilder::parse(const QStringList& arguments) {
+    QString project;
+    QString font;
+    QString face;
+    QString size;
+    QString chars;
+    QString name;
+    QStringList sets;
+    QStringList image_formats;
+    QStringList description_formats;
+    for (int i=1;i<arguments.size();i++) {
+        const QString& arg = arguments[i];
+        if (arg=="--batch") continue;
+        if (arg=="--verify") { m_verify = true; continue; }
+        if (arg=="--skip-unchanged") { m_skip_unchanged = true; continue; }
+        if (i+1>=arguments.size()) {
+            err() << "missing value for " << arg << "\n";
+            return false;
+        }
+        const QString& value = arguments[++i];
+        if (arg=="--project") project = value;
+        else if (arg=="--font") font = value;
+        else if (arg=="--face") face = value;
+        else if (arg=="--size") size = value;
+        else if (arg=="--chars") chars = value;
+        else if (arg=="--layouter") sets << "layout.layouter="+value;
+        else if (arg=="--image-format") image_formats << value;
+        else if (arg=="--description-format") description_formats << value;
+        else if (arg=="--output") sets << "output.path="+value;
+        else if (arg=="--name") name = value;
+        else if (arg=="--set") sets << value;
+        else if (arg=="--perf" || arg=="--trace") continue;
+        else {
+            err() << "unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (!project.isEmpty()) {
+        ProjectFile file;
+        if (!file.Load(project)) {
+            err() << file.errorString() << "\n";
+            return false;
+        }
+        file.apply("fontconfig",m_font_config);
+        file.apply("layoutconfig",m_layout_config);
+        file.apply("outputconfig",m_output_config);
+        m_locked = file.locked();
+    }
+    if (font.isEmpty() && m_font_config->filename().isEmpty()) {
+        err() << "--font or --project is required\n";
+        return false;
+    }
+    // the font file resets face and size, so it goes first
+    if (!font.isEmpty()) {
+        QFileInfo info(font);
+        m_font_config->setPath(info.absolutePath());
+        m_font_config->setFilename(info.fileName());
+    }
+    // a face change resets the size
+    if (!size.isEmpty()) sets.prepend("font.size="+size);
+    if (!face.isEmpty()) sets.prepend("font.faceIndex="+face);
+    if (!chars.isEmpty()) {
+        bool ok = false;
+        m_font_config->setCharacters(readCharacters(chars,&ok));
+        if (!ok) {
+            err() << "can not read " << chars << "\n";
+            return false;
+        }
+    }
+    if (!image_formats.isEmpty()) m_output_config->setImageFormats(image_formats);
+    if (!description_formats.isEmpty()) m_output_config->setDescriptionFormats(description_formats);
+    foreach (const QString& assignment, sets)
+        if (!setProperty(assignment))
+            return false;
+    if (m_font_config->size()<=0) {
+        err() << "--size is required\n";
+        return false;
+    }
+    if (m_layout_config->layouter().isEmpty())
+        m_layout_config->setLayouter("Box layout");
+    if (m_output_config->path().isEmpty())
+        m_output_config->setPath(".");
+
+    // family and style come from the face, like the font selector sets them
+    FontRenderer renderer(0,m_font_config);
+    renderer.open(1.0f);
+    if (!renderer.face()) {
+        err() << "can not open font "
+              << QDir(m_font_config->path()).filePath(m_font_config->filename()) << "\n";
+        return false;
+    }
+    m_font_config->setFamily(renderer.face()->family_name);
+    m_font_config->setStyle(renderer.face()->style_name);
+    // an explicit name wins over the names of a project
+    const bool named = !name.isEmpty();
+    if (!named) {
+        name = m_font_config->family()+ "_" +
+               m_font_config->style()+ "_" +
+               QString().number(m_font_config->size());
+        name = name.toLower().replace(" ","_");
+    }
+    if (named || m_output_config->imageName().isEmpty())
+        m_output_config->setImageName(name);
+    if (named || m_output_config->descriptionName().isEmpty())
+        m_output_config->setDescriptionName(name);
+    return true;
+}
+
+bool BatchBuilder::verify(const ExportJob& job) {
+    ReaderFactory readers;
+    bool ok = true;
+    foreach (const ExportJob::WrittenDescription& written, job.writtenDescriptions()) {
+        AbstractReader* reader = readers.build(written.format,0);
+        if (!reader) {
+            out() << "not verified (no reader): " << written.file << "\n";
+            continue;
+        }
+        QFile file(written.file);
+        QStringList errors;
+        if (!file.open(QFile::ReadOnly))
+            errors << "can not open file";
+        else if (!reader->Read(file.readAll()))
+            errors << reader->errorString();
+        else
+            errors = reader->compare(written.exporter->symbols(),written.exporter->pixelKernings());
+        if (errors.isEmpty()) {
+            out() << "verified: " << written.file << "\n";
+        } else {
+            ok = false;
+            err() << "verify failed: " << written.file << "\n";
+            foreach (const QString& error, errors)
+                err() << "  " << error << "\n";
+        }
+        delete reader;
+    }
+    return ok;
+}
+
+bool BatchBuilder::setupJob(ExportJob& job) {
+    job.setConfig(m_font_config,m_layout_config,m_output_config);
+    job.setSkipUnchanged(m_skip_unchanged);
+    job.setLocked(m_locked);
+    job.setLayouter(m_layout_config->layouter());
+    ImageWriterFactory image_writers;
+    ExporterFactory exporters;
+    foreach (float scale, m_output_config->scaleList()) {
+        job.addPass(scale);
+        if (m_output_config->writeImage()) {
+            foreach (const QString& format, m_output_config->imageFormats()) {
+                AbstractImageWriter* writer = image_writers.build(format,0);
+                if (!writer) {
+                    err() << "unknown image format " << format << "\n";
+                    return false;
+                }
+                job.addImageWriter(format,writer);
+            }
+        }
+        if (m_output_config->writeDescription()) {
+            foreach (const QString& format, m_output_config->descriptionFormats()) {
+                AbstractExporter* exporter = exporters.build(format,0);
+                if (!exporter) {
+                    err() << "unknown description format " << format << "\n";
+                    return false;
+                }
+                job.addExporter(format,exporter);
+            }
+        }
+    }
+    return true;
+}
+
+static QString optionValue(const QStringList& arguments,const QString& option) {
+    int index = arguments.indexOf(option);
+    return index>=0 && index+1<arguments.size() ? arguments[index+1] : QString();
+}
+
+static bool writeReport(const QString& filename,const QByteArray& data) {
+    if (filename=="-") {
+        out() << data;
+        out().flush();
+        return true;
+    }
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly) || file.write(data)!=data.size()) {
+        err() << "can not write " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+int BatchBuilder::run(const QStringList& arguments) {
+    const QString perf = optionValue(arguments,"--perf");
+    const QString trace = optionValue(arguments,"--trace");
+    Perf::setTracing(!trace.isEmpty());
+    int status = build(arguments);
+    if (!perf.isEmpty())
+        writeReport(perf,Perf::json());
+    if (!trace.isEmpty())
+        writeReport(trace,Perf::chromeTrace());
+    err().flush();
+    return status;
+}
+
+int BatchBuilder::build(const QStringList& arguments) {
+    if (arguments.contains("--help") || arguments.contains("-h")) {
+        usage();
+        return Ok;
+    }
+    if (arguments.contains("--list")) {
+        out() << "layouters: " << LayouterFactory().names().join(", ") << "\n";
+        out() << "image formats: " << ImageWriterFactory().names().join(", ") << "\n";
+        out() << "description formats: " << ExporterFactory().names().join(", ") << "\n";
+        out().flush();
+        return Ok;
+    }
+    int manifest = arguments.indexOf("--manifest");
+    if (manifest>=0) {
+        if (manifest+1>=arguments.size()) {
+            err() << "missing value for --manifest\n";
+            return BadArguments;
+        }
+        int jobs = arguments.indexOf("--jobs");
+        int threads = jobs>=0 && jobs+1<arguments.size() ? arguments[jobs+1].toInt() : 0;
+        return runManifest(arguments[manifest+1],threads);
+    }
+    if (!parse(arguments)) {
+        err().flush();
+        usage();
+        return BadArguments;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    ExportJob job;
+    if (!setupJob(job))
+        return BadArguments;
+    if (!job.run()) {
+        err() << "export failed: " << job.errorString() << "\n";
+        return ExportFailed;
+    }
+    out() << (job.skipped() ? "unchanged, skipped " : "exported ")
+          << m_output_config->descriptionName() << " in "
+          << timer.elapsed() << " ms\n";
+    int status = Ok;
+    if (m_verify && !job.skipped() && !verify(job))
+        status = VerifyFailed;
+    out().flush();
+    err().flush();
+    return status;
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+namespace {
+    struct JobResult {
+        bool ok;
+        qint64 ms;
+    };
+
+    JobResult runJob(ExportJob* job) {
+        QElapsedTimer timer;
+        timer.start();
+        JobResult result;
+        result.ok = job->run();
+        result.ms = timer.elapsed();
+        return result;
+    }
+
+    QString manifestValue(const QVariant& value) {
+        if (value.type()==QVariant::List)
+            return value.toStringList().join(",");
+        return value.toString();
+    }
+
+    /// options and properties that name files or directories
+    bool isManifestPath(const QString& key) {
+        return key=="project" || key=="font" || key=="chars" || key=="output" ||
+                key.endsWith(".path");
+    }
+
+    /// a manifest job as the command line it stands for, paths resolved against base
+    QStringList manifestArguments(const QVariantMap& defaults,const QVariantMap& job,const QDir& base) {
+        QVariantMap merged = defaults;
+        QVariantMap sets = defaults.value("set").toMap();
+        for (QVariantMap::ConstIterator it = job.begin();it!=job.end();++it)
+            merged[it.key()] = it.value();
+        QVariantMap job_sets = job.value("set").toMap();
+        for (QVariantMap::ConstIterator it = job_sets.begin();it!=job_sets.end();++it)
+            sets[it.key()] = it.value();
+        merged.remove("set");
+
+        QStringList args;
+        args << QString();
+        for (QVariantMap::ConstIterator it = merged.begin();it!=merged.end();++it) {
+            if (it.value().type()==QVariant::Bool) {
+                if (it.value().toBool())
+                    args << "--"+it.key();
+            } else if (it.value().type()==QVariant::List) {
+                foreach (const QVariant& item, it.value().toList())
+                    args << "--"+it.key() << item.toString();
+            } else if (isManifestPath(it.key())) {
+                args << "--"+it.key() << base.absoluteFilePath(it.value().toString());
+            } else {
+                args << "--"+it.key() << it.value().toString();
+            }
+        }
+        for (QVariantMap::ConstIterator it = sets.begin();it!=sets.end();++it) {
+            if (isManifestPath(it.key()))
+                args << "--set" << it.key()+"="+base.absoluteFilePath(manifestValue(it.value()));
+            else
+                args << "--set" << it.key()+"="+manifestValue(it.value());
+        }
+        return args;
+    }
+}
+#endif
+
+int BatchBuilder::runManifest(const QString& filename,int threads) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+        err() << "can not open manifest " << filename << "\n";
+        return BadArguments;
+    }
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(),&error);
+    if (doc.isNull() || !doc.isObject()) {
+        err() << "invalid manifest " << filename << ": " << error.errorString() << "\n";
+        return BadArguments;
+    }
+    const QVariantMap defaults = doc.object().value("defaults").toObject().toVariantMap();
+    const QJsonArray list = doc.object().value("jobs").toArray();
+    const QDir base = QFileInfo(filename).absoluteDir();
+
+    QElapsedTimer timer;
+    timer.start();
+    RenderCache cache;
+    QList<BatchBuilder*> builders;
+    QList<ExportJob*> jobs;
+    QList<QFuture<JobResult> > results;
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads>0 ? threads : QThread::idealThreadCount());
+    int status = Ok;
+    for (int i=0;i<list.size();i++) {
+        BatchBuilder* builder = new BatchBuilder(this);
+        ExportJob* job = new ExportJob(this);
+        if (!builder->parse(manifestArguments(defaults,list[i].toObject().toVariantMap(),base))
+                || !builder->setupJob(*job)) {
+            err() << "job " << i << ": invalid options\n";
+            delete builder;
+            delete job;
+            status = BadArguments;
+            continue;
+        }
+        job->setRenderCache(&cache);
+        builders.push_back(builder);
+        jobs.push_back(job);
+        results.push_back(QtConcurrent::run(&pool,runJob,job));
+    }
+
+    int failed = 0;
+    int skipped = 0;
+    out() << QString("%1 %2 %3 %4\n").arg("job",-40).arg("status",-8).arg("ms",8).arg("atlas");
+    for (int i=0;i<jobs.size();i++) {
+        const JobResult result = results[i].result();
+        bool ok = result.ok;
+        QStringList sizes;
+        foreach (const QSize& size, jobs[i]->atlasSizes())
+            sizes << QString("%1x%2").arg(size.width()).arg(size.height());
+        out() << QString("%1 %2 %3 %4\n")
+                 .arg(builders[i]->m_output_config->descriptionName(),-40)
+                 .arg(!ok ? "failed" : jobs[i]->skipped() ? "skipped" : "ok",-8)
+                 .arg(result.ms,8)
+                 .arg(sizes.join(" "));
+        if (!ok)
+            err() << "  " << jobs[i]->errorString() << "\n";
+        if (ok && jobs[i]->skipped())
+            skipped++;
+        else if (ok && builders[i]->m_verify && !builders[i]->verify(*jobs[i])) {
+            ok = false;
+            if (status==Ok) status = VerifyFailed;
+        }
+        if (!ok) {
+            failed++;
+            if (status==Ok) status = ExportFailed;
+        }
+    }
+    out() << jobs.size() << " jobs, " << jobs.size()-failed-skipped << " rebuilt, "
+          << skipped << " skipped, " << failed << " failed, "
+          << cache.renders() << " renders, " << cache.hits() << " shared, "
+          << timer.elapsed() << " ms\n";
+    qDeleteAll(jobs);
+    qDeleteAll(builders);
+    out().flush();
+    err().flush();
+    return status;
+#else
+    Q_UNUSED(filename);
+    Q_UNUSED(threads);
+    err() << "manifests need Qt 5 for JSON support\n";
+    err().flush();
+    return BadArguments;
+#endif
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BATCHBUILDER_H
+#define BATCHBUILDER_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "rendererdata.h"
+
+class FontConfig;
+class LayoutConfig;
+class OutputConfig;
+class ExportJob;
+
+/// Headless export driven by command line arguments, runs the same
+/// render, layout and export steps as the GUI without any widgets.
+/// A JSON manifest runs many such exports on a pool of threads.
+class BatchBuilder : public QObject
+{
+Q_OBJECT
+public:
+    explicit BatchBuilder(QObject *parent = 0);
+
+    enum Status {
+        Ok = 0,
+        ExportFailed = 1,
+        BadArguments = 2,
+        VerifyFailed = 3
+    };
+
+    /// arguments as QCoreApplication::arguments(), returns a Status
+    int run(const QStringList& arguments);
+    static void usage();
+private:
+    FontConfig* m_font_config;
+    LayoutConfig* m_layout_config;
+    OutputConfig* m_output_config;
+    bool m_verify;
+    bool m_skip_unchanged;
+    RendererData m_locked;
+
+    int build(const QStringList& arguments);
+    bool parse(const QStringList& arguments);
+    bool setProperty(const QString& assignment);
+    bool setupJob(ExportJob& job);
+    bool verify(const ExportJob& job);
+    int runManifest(const QString& filename,int threads);
+signals:
+
+public slots:
+
+};
+
+#endif // BATCHBUILDER_H
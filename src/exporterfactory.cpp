@@ -41,6 +41,8 @@ extern AbstractExporter* SparrowExporterFactoryFunc (QObject*);
 extern AbstractExporter* SimpleExporterFactoryFunc (QObject*);
 extern AbstractExporter* MyGUIExporterFactoryFunc (QObject*);
 extern AbstractExporter* BMFontExporterFactoryFunc (QObject*);
+extern AbstractExporter* BMFontBinaryExporterFactoryFunc (QObject*);
+extern AbstractExporter* RuntimeExporterFactoryFunc (QObject*);
 
 ExporterFactory::ExporterFactory(QObject *parent) :
     QObject(parent)
@@ -55,6 +57,8 @@ ExporterFactory::ExporterFactory(QObject *parent) :
     m_factorys["Simple"] = &SimpleExporterFactoryFunc;
     m_factorys["MyGUI"] = &MyGUIExporterFactoryFunc;
     m_factorys["BMFont"] = &BMFontExporterFactoryFunc;
+    m_factorys["BMFont (binary)"] = &BMFontBinaryExporterFactoryFunc;
+    m_factorys["Runtime blob (FBR)"] = &RuntimeExporterFactoryFunc;
 }
 
 
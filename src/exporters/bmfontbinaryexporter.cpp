@@ -0,0 +1,122 @@
+#include "bmfontbinaryexporter.h"
+#include "../fontconfig.h"
+
+#include <QtEndian>
+#include <cstring>
+
+BMFontBinaryExporter::BMFontBinaryExporter(QObject *parent) :
+    AbstractExporter(parent)
+{
+    setExtension("fnt");
+}
+
+namespace {
+    enum BlockType {
+        BlockInfo = 1,
+        BlockCommon = 2,
+        BlockPages = 3,
+        BlockChars = 4,
+        BlockKerning = 5
+    };
+    const int InfoSize = 14;
+    const int CommonSize = 15;
+    const int CharSize = 20;
+    const int KerningSize = 10;
+
+    /// little endian writer over a preallocated buffer
+    class Writer {
+    public:
+        explicit Writer(uchar* data) : m_data(data) {}
+        void u8(uint v) { *m_data++ = uchar(v); }
+        void i8(int v) { *m_data++ = uchar(qint8(qBound(-128,v,127))); }
+        void u16(uint v) { qToLittleEndian<quint16>(quint16(v),m_data); m_data+=2; }
+        void i16(int v) { qToLittleEndian<qint16>(qint16(v),m_data); m_data+=2; }
+        void u32(uint v) { qToLittleEndian<quint32>(quint32(v),m_data); m_data+=4; }
+        void str(const QByteArray& s) { ::memcpy(m_data,s.constData(),s.size()); m_data+=s.size(); *m_data++ = 0; }
+        void block(BlockType type,int size) { u8(type); u32(size); }
+    private:
+        uchar* m_data;
+    };
+}
+
+bool BMFontBinaryExporter::Export(QByteArray &out)
+{
+    // Format description:
+    // http://www.angelcode.com/products/bmfont/doc/file_format.html#bin
+    // Records have fixed size, so the chars block can be mapped and indexed in place.
+
+    const FontConfig* cfg = fontConfig();
+    const QByteArray face = cfg->family().toUtf8();
+    const QByteArray page = texFilename().toUtf8();
+
+    const QVector<KerningPair> pairs = pixelKernings();
+    const int kerningCount = pairs.size();
+
+    int size = 4;
+    size += 5 + InfoSize + face.size() + 1;
+    size += 5 + CommonSize;
+    size += 5 + page.size() + 1;
+    size += 5 + CharSize * symbols().size();
+    if (kerningCount)
+        size += 5 + KerningSize * kerningCount;
+
+    out.resize(size);
+    Writer w(reinterpret_cast<uchar*>(out.data()));
+    w.u8('B'); w.u8('M'); w.u8('F'); w.u8(3);
+
+    w.block(BlockInfo,InfoSize + face.size() + 1);
+    w.i16(cfg->size());
+    w.u8((cfg->antialiased() ? 1 : 0) | (1 << 1) |
+         (cfg->italic() ? (1 << 2) : 0) | (cfg->bold() ? (1 << 3) : 0));
+    w.u8(0);        // charSet, unused with unicode
+    w.u16(qRound(cfg->height()));     // stretchH, percent
+    w.u8(1);        // aa
+    w.u8(0); w.u8(0); w.u8(0); w.u8(0);     // padding
+    // spacing can be negative, stored as two's complement bytes
+    w.i8(cfg->charSpacing());
+    w.i8(cfg->lineSpacing());
+    w.u8(0);        // outline
+    w.str(face);
+
+    w.block(BlockCommon,CommonSize);
+    w.u16(metrics().height);
+    w.u16(metrics().ascender);
+    w.u16(texWidth());
+    w.u16(texHeight());
+    w.u16(1);       // pages
+    w.u8(0);        // not packed
+    w.u8(0);        // alpha holds glyph
+    w.u8(4); w.u8(4); w.u8(4);  // color channels are one
+
+    w.block(BlockPages,page.size() + 1);
+    w.str(page);
+
+    w.block(BlockChars,CharSize * symbols().size());
+    foreach(const Symbol& c , symbols()) {
+        w.u32(c.id);
+        w.u16(c.placeX);
+        w.u16(c.placeY);
+        w.u16(c.placeW);
+        w.u16(c.placeH);
+        w.i16(c.offsetX);
+        w.i16(metrics().ascender - c.offsetY);
+        w.i16(c.advance);
+        w.u8(0);    // page
+        w.u8(15);   // all channels
+    }
+
+    if (kerningCount) {
+        w.block(BlockKerning,KerningSize * kerningCount);
+        foreach(const KerningPair& k , pairs) {
+            w.u32(k.first);
+            w.u32(k.second);
+            w.i16(k.amount);
+        }
+    }
+
+    return true;
+}
+
+AbstractExporter* BMFontBinaryExporterFactoryFunc (QObject* parent) {
+    return new BMFontBinaryExporter(parent);
+}
@@ -0,0 +1,19 @@
+#ifndef BMFONTBINARYEXPORTER_H
+#define BMFONTBINARYEXPORTER_H
+
+#include "../abstractexporter.h"
+
+class BMFontBinaryExporter : public AbstractExporter
+{
+    Q_OBJECT
+public:
+    explicit BMFontBinaryExporter(QObject *parent = 0);
+
+    virtual bool Export(QByteArray& out);
+signals:
+
+public slots:
+
+};
+
+#endif // BMFONTBINARYEXPORTER_H
@@ -30,7 +30,7 @@
 
 #include "divoexporter.h"
 #include "../fontconfig.h"
-#include <QtXml>
+#include "xmlwriter.h"
 
 DivoExporter::DivoExporter(QObject *parent) :
     AbstractExporter(parent)
@@ -40,41 +40,41 @@ DivoExporter::DivoExporter(QObject *parent) :
 
 
 bool DivoExporter::Export(QByteArray& out) {
-    QDomDocument doc;
-    doc.appendChild(doc.createProcessingInstruction("xml","version=\"1.0\" encoding=\"utf-8\"" ));
-    QDomElement root = doc.createElement("Font");
-    doc.appendChild(root);
+    XmlWriter xml(out);
+    xml.writeDeclaration();
 
-    root.setAttribute("family",fontConfig()->family());
-    root.setAttribute("style",fontConfig()->style());
-    root.setAttribute("size",fontConfig()->size());
-    root.setAttribute("height",metrics().height);
+    xml.startElement("Font");
+    xml.attribute("family",fontConfig()->family());
+    xml.attribute("style",fontConfig()->style());
+    xml.attribute("size",fontConfig()->size());
+    xml.attribute("height",metrics().height);
 
     int offset = metrics().ascender;
 
     foreach (const Symbol& c , symbols()) {
-        QDomElement ce = doc.createElement("Char");
-        ce.setAttribute("code",QString().append(c.id));
+        xml.startElement("Char");
+        xml.attribute("code",QString().append(c.id));
         char buf[64];
         ::snprintf(buf,63,"%d %d %d %d",c.placeX,c.placeY,c.placeW,c.placeH);
-        ce.setAttribute("rect",buf);
+        xml.attribute("rect",buf);
         ::snprintf(buf,63,"%d %d",c.offsetX,offset-c.offsetY);
-        ce.setAttribute("offset",buf);
-        ce.setAttribute("width",c.advance);
-        typedef QMap<uint,int>::ConstIterator Kerning;
-        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-            QDomElement ke = doc.createElement("Kerning");
-            ke.setAttribute("id",QString().append(k.key()));
-            ke.setAttribute("advance",k.value());
-            ce.appendChild(ke);
+        xml.attribute("offset",buf);
+        xml.attribute("width",c.advance);
+        for ( const KerningPair* k = kerningBegin(c);k!=kerningEnd(c);k++) {
+            if (!k->amount)
+                continue;
+            xml.startElement("Kerning");
+            xml.attribute("id",QString().append(k->second));
+            xml.attribute("advance",k->amount);
+            xml.endElement();
         }
-        root.appendChild(ce);
+        xml.endElement();
     }
-    out = doc.toByteArray(1);
+
+    xml.endElement();
     return true;
 }
 
-
 AbstractExporter* DivoExporterFactoryFunc (QObject* parent) {
     return new DivoExporter(parent);
 }
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Runtime font blob ("FBR") layout and reference reader.
+ *
+ * The blob is position independent: every offset is relative to the
+ * start of the blob, so it can be mapped from disk and used in place.
+ * All values are little endian and every table is 4 byte aligned; the
+ * reader below accesses the structures directly and therefore expects a
+ * little endian host.
+ *
+ * Layout:
+ *   fbr_header
+ *   int32_t     buckets[bucket_count]     perfect hash displacements
+ *   fbr_glyph   glyphs[glyph_count]       indexed by hash slot
+ *   fbr_kerning kernings[kerning_count]   per glyph ranges, sorted by second
+ *   int32_t     classes[left_class_count * right_class_count]
+ *                                         kerning class matrix, row major
+ *   char        texture[]                 NUL terminated, utf-8
+ *   char        name[]                    NUL terminated, utf-8
+ *
+ * Advances, kerning amounts and the *64 metrics are 26.6 fixed point pixels. A blob holds
+ * either kerning pairs or, with FBR_FLAG_KERNING_CLASSES, a class matrix
+ * indexed by the left class of the first and right class of the second
+ * glyph.
+ */
+
+#ifndef FBRUNTIME_H
+#define FBRUNTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FBR_MAGIC   0x00524246u     /* "FBR\0" */
+#define FBR_VERSION 2u
+
+#define FBR_FLAG_KERNING_CLASSES 0x1u
+
+typedef struct fbr_metrics {
+    int32_t  size;
+    int32_t  ascender;
+    int32_t  descender;
+    int32_t  line_height;
+    uint32_t tex_width;
+    uint32_t tex_height;
+    int32_t  ascender64;        /* 26.6, the integer values are truncated */
+    int32_t  descender64;
+    int32_t  line_height64;
+} fbr_metrics;
+
+typedef struct fbr_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;              /* whole blob in bytes */
+    uint32_t flags;
+    uint32_t glyph_count;
+    uint32_t kerning_count;
+    uint32_t bucket_count;
+    uint32_t buckets_offset;
+    uint32_t glyphs_offset;
+    uint32_t kernings_offset;
+    uint32_t left_class_count;
+    uint32_t right_class_count;
+    uint32_t classes_offset;
+    uint32_t texture_offset;
+    uint32_t name_offset;
+    fbr_metrics metrics;
+} fbr_header;
+
+typedef struct fbr_glyph {
+    uint32_t code;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+    int16_t  offset_x;          /* left bearing */
+    int16_t  offset_y;          /* bitmap top above the baseline */
+    int32_t  advance;           /* 26.6 */
+    uint32_t kerning_begin;
+    uint16_t kerning_count;
+    uint16_t page;
+    uint16_t left_class;
+    uint16_t right_class;
+} fbr_glyph;
+
+typedef struct fbr_kerning {
+    uint32_t second;
+    int32_t  amount;            /* 26.6 */
+} fbr_kerning;
+
+/* Hash shared by the exporter and the reader. Seed 0 selects the bucket,
+ * the bucket displacement selects the slot. */
+static inline uint32_t fbr_hash(uint32_t code, uint32_t seed)
+{
+    uint32_t h = code ^ (seed * 0x9e3779b9u);
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline int fbr_table_fits(uint32_t offset, uint32_t count, uint32_t item, uint32_t size)
+{
+    return (offset & 3u) == 0 && offset <= size && count <= (size - offset) / item;
+}
+
+/* Validates the header and table bounds. Returns NULL if data is not a blob. */
+static inline const fbr_header* fbr_open(const void* data, size_t size)
+{
+    const fbr_header* h = (const fbr_header*)data;
+    if (!data || ((uintptr_t)data & 3u) || size < sizeof(fbr_header))
+        return NULL;
+    if (h->magic != FBR_MAGIC || h->version != FBR_VERSION || h->size > size || h->size < sizeof(fbr_header))
+        return NULL;
+    if (!fbr_table_fits(h->buckets_offset, h->bucket_count, sizeof(int32_t), h->size) ||
+        !fbr_table_fits(h->glyphs_offset, h->glyph_count, sizeof(fbr_glyph), h->size) ||
+        !fbr_table_fits(h->kernings_offset, h->kerning_count, sizeof(fbr_kerning), h->size))
+        return NULL;
+    if (!fbr_table_fits(h->classes_offset, h->left_class_count, sizeof(int32_t), h->size) ||
+        (h->left_class_count && h->right_class_count > (h->size - h->classes_offset) / sizeof(int32_t) / h->left_class_count))
+        return NULL;
+    if ((h->glyph_count && !h->bucket_count) || h->texture_offset >= h->size || h->name_offset >= h->size)
+        return NULL;
+    /* strings live at the end, a terminating NUL keeps them inside the blob */
+    if (((const char*)data)[h->size - 1] != 0)
+        return NULL;
+    return h;
+}
+
+static inline const fbr_glyph* fbr_glyphs(const fbr_header* h)
+{
+    return (const fbr_glyph*)((const char*)h + h->glyphs_offset);
+}
+
+static inline const char* fbr_texture(const fbr_header* h)
+{
+    return (const char*)h + h->texture_offset;
+}
+
+static inline const char* fbr_name(const fbr_header* h)
+{
+    return (const char*)h + h->name_offset;
+}
+
+/* One hash, one table load and one compare. NULL if code is not in the font. */
+static inline const fbr_glyph* fbr_find_glyph(const fbr_header* h, uint32_t code)
+{
+    const int32_t* buckets = (const int32_t*)((const char*)h + h->buckets_offset);
+    const fbr_glyph* glyph;
+    int32_t d;
+    uint32_t slot;
+    if (!h->glyph_count)
+        return NULL;
+    d = buckets[fbr_hash(code, 0) % h->bucket_count];
+    slot = d < 0 ? (uint32_t)(-(d + 1)) : fbr_hash(code, (uint32_t)d) % h->glyph_count;
+    if (slot >= h->glyph_count)
+        return NULL;
+    glyph = fbr_glyphs(h) + slot;
+    return glyph->code == code ? glyph : NULL;
+}
+
+/* Kerning between two glyphs of the blob, 26.6. */
+static inline int32_t fbr_find_kerning(const fbr_header* h, const fbr_glyph* first, const fbr_glyph* second)
+{
+    const fbr_kerning* k = (const fbr_kerning*)((const char*)h + h->kernings_offset);
+    uint32_t lo, hi;
+    if (h->flags & FBR_FLAG_KERNING_CLASSES) {
+        const int32_t* classes = (const int32_t*)((const char*)h + h->classes_offset);
+        if (first->left_class >= h->left_class_count || second->right_class >= h->right_class_count)
+            return 0;
+        return classes[first->left_class * h->right_class_count + second->right_class];
+    }
+    lo = first->kerning_begin;
+    hi = lo + first->kerning_count;
+    if (hi > h->kerning_count || lo > hi)
+        return 0;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (k[mid].second < second->code)
+            lo = mid + 1;
+        else if (k[mid].second > second->code)
+            hi = mid;
+        else
+            return k[mid].amount;
+    }
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FBRUNTIME_H */
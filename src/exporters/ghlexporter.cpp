@@ -31,7 +31,7 @@
 #include "ghlexporter.h"
 #include "../fontconfig.h"
 #include "../layoutdata.h"
-#include <QDomDocument>
+#include "xmlwriter.h"
 
 GHLExporter::GHLExporter(QObject *parent) :
     AbstractExporter(parent)
@@ -40,58 +40,56 @@ GHLExporter::GHLExporter(QObject *parent) :
 }
 
 bool GHLExporter::Export(QByteArray& out) {
-    QDomDocument doc;
-    QDomElement root = doc.createElement("font");
+    XmlWriter xml(out);
+    xml.writeDeclaration();
 
-    doc.appendChild(doc.createProcessingInstruction("xml","version=\"1.0\" encoding=\"utf-8\"" ));
+    xml.startElement("font");
+    xml.attribute("type","GHL");
 
-    doc.appendChild(root);
-    root.setAttribute("type","GHL");
+    xml.startElement("description");
+    xml.attribute("family",fontConfig()->family());
+    xml.attribute("style",fontConfig()->style());
+    xml.attribute("size",fontConfig()->size());
+    xml.endElement();
 
-    QDomElement descr = doc.createElement("description");
-    descr.setAttribute("family",fontConfig()->family());
-    descr.setAttribute("style",fontConfig()->style());
-    descr.setAttribute("size",fontConfig()->size());
-    root.appendChild(descr);
+    xml.startElement("metrics");
+    xml.attribute("ascender",metrics().ascender);
+    xml.attribute("descender",metrics().descender);
+    xml.attribute("height",metrics().height);
+    xml.endElement();
 
-    QDomElement fmetrics = doc.createElement("metrics");
-    fmetrics.setAttribute("ascender",metrics().ascender);
-    fmetrics.setAttribute("descender",metrics().descender);
-    fmetrics.setAttribute("height",metrics().height);
-    root.appendChild(fmetrics);
+    xml.startElement("texture");
+    xml.attribute("width",texWidth());
+    xml.attribute("height",texHeight());
+    xml.attribute("file",texFilename());
+    xml.endElement();
 
-    QDomElement tex = doc.createElement("texture");
-    tex.setAttribute("width",texWidth());
-    tex.setAttribute("height",texHeight());
-    tex.setAttribute("file",texFilename());
-    root.appendChild(tex);
-
-    QDomElement chars = doc.createElement("chars");
+    xml.startElement("chars");
     foreach (const Symbol& c , symbols()) {
-        QDomElement ce = doc.createElement("char");
-        ce.setAttribute("id",QString().append(c.id));
+        xml.startElement("char");
+        xml.attribute("id",QString().append(c.id));
         char buf[64];
         ::snprintf(buf,63,"%d %d %d %d",c.placeX,c.placeY,c.placeW,c.placeH);
-        ce.setAttribute("rect",buf);
+        xml.attribute("rect",buf);
         ::snprintf(buf,63,"%d %d",c.offsetX,c.offsetY);
-        ce.setAttribute("offset",buf);
-        ce.setAttribute("advance",c.advance);
-        typedef QMap<uint,int>::ConstIterator Kerning;
-        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-            QDomElement ke = doc.createElement("kerning");
-            ke.setAttribute("id",QString().append(k.key()));
-            ke.setAttribute("advance",k.value());
-            ce.appendChild(ke);
+        xml.attribute("offset",buf);
+        xml.attribute("advance",c.advance);
+        for ( const KerningPair* k = kerningBegin(c);k!=kerningEnd(c);k++) {
+            if (!k->amount)
+                continue;
+            xml.startElement("kerning");
+            xml.attribute("id",QString().append(k->second));
+            xml.attribute("advance",k->amount);
+            xml.endElement();
         }
-
-        chars.appendChild(ce);
+        xml.endElement();
     }
-    root.appendChild(chars);
-    out = doc.toByteArray(1);
+    xml.endElement();
+
+    xml.endElement();
     return true;
 }
 
-
 AbstractExporter* GHLExporterFactoryFunc (QObject* parent) {
     return new GHLExporter(parent);
 }
@@ -31,85 +31,119 @@
 #include "luaexporter.h"
 #include "../fontconfig.h"
 #include "../layoutdata.h"
+#include "../kerningclasses.h"
+
+#include "textwriter.h"
 
-#include <QString>
 LuaExporter::LuaExporter(bool write_function,QObject *parent) :
     AbstractExporter(parent), m_write_function(write_function)
 {
     setExtension("lua");
 }
-static QString charCode(uint code) {
-    if (code=='\"') return QString().append('\'').append(code).append('\'');
-    if (code=='\\') return QString("\"\\\\\"");
-    return QString().append('\"').append(code).append('\"');
+
+static void writeCharCode(TextWriter& w,uint code) {
+    if (code=='\"') { w << "'\"'"; return; }
+    if (code=='\\') { w << "\"\\\\\""; return; }
+    w << '\"';
+    if (code<0x80)
+        w << char(code);
+    else
+        w << QString(QChar(code));
+    w << '\"';
 }
 
 bool LuaExporter::Export(QByteArray& out) {
-    QString res;
+    TextWriter w(out);
+    w.reserve(1024 + symbols().size()*96 + kernings().size()*40);
     if (m_write_function)
-        res+="return {\n";
-    const QString p(m_write_function ? "\t":"");
-    res+=p+QString("file=\"")+texFilename()+QString(m_write_function ? "\",\n" : "\"\n");
-    res+=p+QString("height=")+QString().number(metrics().height)+QString(m_write_function?",\n":"\n");
-    res+=p+QString("description={\n");
-    res+=p+QString("\tfamily=\"")+fontConfig()->family()+QString("\",\n");
-    res+=p+QString("\tstyle=\"")+fontConfig()->style()+QString("\",\n");
-    res+=p+QString("\tsize=")+QString().number(fontConfig()->size())+QString("\n");
-    res+=p+QString(m_write_function?"},\n":"}\n");
+        w << "return {\n";
+    const char* p = m_write_function ? "\t" : "";
+    const char* close = m_write_function ? "},\n" : "}\n";
+    w << p << "file=\"" << texFilename() << (m_write_function ? "\",\n" : "\"\n");
+    w << p << "height=" << metrics().height << (m_write_function ? ",\n" : "\n");
+    w << p << "description={\n";
+    w << p << "\tfamily=\"" << fontConfig()->family() << "\",\n";
+    w << p << "\tstyle=\"" << fontConfig()->style() << "\",\n";
+    w << p << "\tsize=" << fontConfig()->size() << "\n";
+    w << p << close;
 
-    res+=p+QString("metrics={\n");
-    res+=p+QString("\tascender=")+QString().number(metrics().ascender)+QString(",\n");
-    res+=p+QString("\tdescender=")+QString().number(metrics().descender)+QString(",\n");
-    res+=p+QString("\theight=")+QString().number(metrics().height)+QString("\n");
-    res+=p+QString(m_write_function?"},\n":"}\n");
+    w << p << "metrics={\n";
+    w << p << "\tascender=" << metrics().ascender << ",\n";
+    w << p << "\tdescender=" << metrics().descender << ",\n";
+    w << p << "\theight=" << metrics().height << "\n";
+    w << p << close;
 
-    res+=p+QString("texture={\n");
-    res+=p+QString("\tfile=\"")+texFilename()+QString("\",\n");
-    res+=p+QString("\twidth=")+QString().number(texWidth())+QString(",\n");
-    res+=p+QString("\theight=")+QString().number(texHeight())+QString("\n");
-    res+=p+QString(m_write_function?"},\n":"}\n");
+    w << p << "texture={\n";
+    w << p << "\tfile=\"" << texFilename() << "\",\n";
+    w << p << "\twidth=" << texWidth() << ",\n";
+    w << p << "\theight=" << texHeight() << "\n";
+    w << p << close;
 
-    res+=p+QString("chars={\n");
+    w << p << "chars={\n";
     foreach (const Symbol& c , symbols()) {
-        QString charDef="{char=";
-        charDef+=charCode(c.id);
-        charDef+=QString(",");
-        charDef+=QString("width=")+QString().number(c.advance)+QString(",");
-        charDef+=QString("x=")+QString().number(c.placeX)+QString(",");
-        charDef+=QString("y=")+QString().number(c.placeY)+QString(",");
-        charDef+=QString("w=")+QString().number(c.placeW)+QString(",");
-        charDef+=QString("h=")+QString().number(c.placeH)+QString(",");
-
-        charDef+=QString("ox=")+QString().number(c.offsetX)+QString(",");
-        charDef+=QString("oy=")+QString().number(c.offsetY)+QString("}");
+        w << p << "\t{char=";
+        writeCharCode(w,c.id);
+        w << ",width=" << c.advance
+          << ",x=" << c.placeX
+          << ",y=" << c.placeY
+          << ",w=" << c.placeW
+          << ",h=" << c.placeH
+          << ",ox=" << c.offsetX
+          << ",oy=" << c.offsetY << "},\n";
+    }
+    w << p << close;
+    if (const KerningClasses* classes = kerningClasses())
+        writeKerningClasses(w,p,classes);
+    else
+        writeKernings(w,p);
+    if (m_write_function)
+        w << "}\n";
+    return true;
+}
 
-        res+=p+QString("\t")+charDef+QString(",\n");
+void LuaExporter::writeKerningClasses(TextWriter& w,const char* p,const KerningClasses* classes) const {
+    // amount = matrix[left[first]+1][right[second]+1], every exported glyph
+    // has a class, class 0 has no kerning
+    w << p << "kerningClasses={\n";
+    w << p << "\tleft={";
+    foreach (const Symbol& c , symbols()) {
+        w << '[';
+        writeCharCode(w,c.id);
+        w << "]=" << classes->leftClass(c.id) << ',';
     }
-    res+=p+QString(m_write_function?"},\n":"}\n");
-    QString kernings;
+    w << "},\n";
+    w << p << "\tright={";
     foreach (const Symbol& c , symbols()) {
-        QString charDef="{from=";
-        charDef+=charCode(c.id);
-        charDef+=QString(",to=");
-        typedef QMap<uint,int>::ConstIterator Kerning;
-        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-            QString def = charDef;
-            def+=charCode(k.key());
-            def+=QString(",offset=")+QString().number(k.value())+QString("}");
-            kernings+=p+QString("\t")+def+QString(",\n");
-        }
+        w << '[';
+        writeCharCode(w,c.id);
+        w << "]=" << classes->rightClass(c.id) << ',';
     }
-    if (kernings.length()>2) {
-        res+=p+QString("kernings={\n");
-        res+=kernings;
-        res+=p+QString("}\n");
+    w << "},\n";
+    w << p << "\tmatrix={\n";
+    for (int l=0;l<classes->leftCount();l++) {
+        w << p << "\t\t{";
+        for (int r=0;r<classes->rightCount();r++)
+            w << classes->amount(l,r) << ',';
+        w << "},\n";
     }
-    if (m_write_function)
-        res+=QString("}\n");
-    out = res.toUtf8();
-    return true;
+    w << p << "\t}\n";
+    w << p << "}\n";
 }
 
+void LuaExporter::writeKernings(TextWriter& w,const char* p) const {
+    const QVector<KerningPair> pairs = pixelKernings();
+    if (pairs.isEmpty())
+        return;
+    w << p << "kernings={\n";
+    foreach (const KerningPair& k , pairs) {
+        w << p << "\t{from=";
+        writeCharCode(w,k.first);
+        w << ",to=";
+        writeCharCode(w,k.second);
+        w << ",offset=" << k.amount << "},\n";
+    }
+    w << p << "}\n";
+}
 
 AbstractExporter* LuaTableExporterFactoryFunc (QObject* parent) {
     return new LuaExporter(false,parent);
@@ -33,6 +33,9 @@
 
 #include "../abstractexporter.h"
 
+class KerningClasses;
+class TextWriter;
+
 class LuaExporter : public AbstractExporter
 {
 Q_OBJECT
@@ -40,6 +43,8 @@ public:
     explicit LuaExporter(bool write_function,QObject *parent = 0);
 protected:
     virtual bool Export(QByteArray& out);
+    void writeKernings(TextWriter& w,const char* p) const;
+    void writeKerningClasses(TextWriter& w,const char* p,const KerningClasses* classes) const;
 signals:
 
 public slots:
@@ -32,7 +32,7 @@
 #include "../fontconfig.h"
 #include "../layoutdata.h"
 #include "../layoutconfig.h"
-#include <QDomDocument>
+#include "xmlwriter.h"
 #include FT_TRUETYPE_TABLES_H
 
 MyGUIExporter::MyGUIExporter(QObject *parent) : AbstractExporter(parent)
@@ -40,18 +40,16 @@ MyGUIExporter::MyGUIExporter(QObject *parent) : AbstractExporter(parent)
     setExtension("xml");
 }
 
-static void appendProperty(QDomDocument& doc,QDomElement& el,QString name,QString value) {
-    QDomElement p = doc.createElement("Property");
-    p.setAttribute("key",name);
-    p.setAttribute("value",value);
-    el.appendChild(p);
+static void appendProperty(XmlWriter& xml,const char* name,const QString& value) {
+    xml.startElement("Property");
+    xml.attribute("key",name);
+    xml.attribute("value",value);
+    xml.endElement();
 }
 
 bool MyGUIExporter::Export(QByteArray& out) {
-    QDomDocument doc;
-    doc.appendChild(doc.createProcessingInstruction("xml","version=\"1.0\" encoding=\"utf-8\"" ));
-
-    QDomElement root = doc.createElement("MyGUI");
+    XmlWriter xml(out);
+    xml.writeDeclaration();
 
     float iscale = 1.0f / scale();
     float scale = iscale;
@@ -77,45 +75,44 @@ bool MyGUIExporter::Export(QByteArray& out) {
             descender = v;
     }
 
-    doc.appendChild(root);
-    root.setAttribute("type","Resource");
-    root.setAttribute("version","1.0");
+    xml.startElement("MyGUI");
+    xml.attribute("type","Resource");
+    xml.attribute("version","1.0");
 
-    QDomElement descr = doc.createElement("Resource");
-    descr.setAttribute("type","ResourceManualFont");
-    descr.setAttribute("name",fontConfig()->family()+"-"
+    xml.startElement("Resource");
+    xml.attribute("type","ResourceManualFont");
+    xml.attribute("name",fontConfig()->family()+"-"
                        +fontConfig()->style()+"-"+QString("%1").arg(fontConfig()->size()));
-    appendProperty(doc,descr,"Source",texFilename());
-    appendProperty(doc,descr,"SourceSize",QString("%1 %2").arg(texWidth()* scale).arg(texHeight()* scale));
-    appendProperty(doc,descr,"DefaultHeight",QString("%1").arg(ascender+descender));
+    appendProperty(xml,"Source",texFilename());
+    appendProperty(xml,"SourceSize",QString("%1 %2").arg(texWidth()* scale).arg(texHeight()* scale));
+    appendProperty(xml,"DefaultHeight",QString("%1").arg(ascender+descender));
 
-    QDomElement chars = doc.createElement("Codes");
+    xml.startElement("Codes");
     foreach (const Symbol& c , symbols()) {
-        QDomElement ce = doc.createElement("Code");
-        ce.setAttribute("index",QString("%1").arg(c.id));
+        xml.startElement("Code");
+        xml.attribute("index",QString("%1").arg(c.id));
         char buf[64];
         ::snprintf(buf,63,"%d %d %d %d",c.placeX,c.placeY,c.placeW,c.placeH);
-        ce.setAttribute("coord",buf);
+        xml.attribute("coord",buf);
         ::snprintf(buf,63,"%f %f",c.offsetX * scale,ascender-c.offsetY * scale);
-        ce.setAttribute("bearing",buf);
-        ce.setAttribute("advance",c.advance* scale-c.offsetX* scale);
+        xml.attribute("bearing",buf);
+        xml.attribute("advance",c.advance64* scale/64.0f-c.offsetX* scale);
         if (scale!=1.0f) {
             ::snprintf(buf,63,"%f %f",c.placeW * scale,c.placeH * scale);
-            ce.setAttribute("size",buf);
+            xml.attribute("size",buf);
         }
-//        typedef QMap<uint,int>::ConstIterator Kerning;
-//        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-//            QDomElement ke = doc.createElement("kerning");
-//            ke.setAttribute("id",QString().append(k.key()));
-//            ke.setAttribute("advance",k.value());
-//            ce.appendChild(ke);
+//        for ( const KerningPair* k = kerningBegin(c);k!=kerningEnd(c);k++) {
+//            xml.startElement("kerning");
+//            xml.attribute("id",QString().append(k->second));
+//            xml.attribute("advance",k->amount);
+//            xml.endElement();
 //        }
-
-        chars.appendChild(ce);
+        xml.endElement();
     }
-    descr.appendChild(chars);
-    root.appendChild(descr);
-    out = doc.toByteArray(1);
+    xml.endElement();
+
+    xml.endElement();
+    xml.endElement();
     return true;
 }
 
@@ -40,6 +40,7 @@ public:
     explicit MyGUIExporter(QObject *parent = 0);
 
     virtual bool Export(QByteArray& out);
+    virtual bool needsFace() const { return true; }
 signals:
 
 public slots:
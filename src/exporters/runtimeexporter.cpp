@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "runtimeexporter.h"
+#include "fbruntime.h"
+#include "../fontconfig.h"
+#include "../kerningclasses.h"
+
+#include <QtEndian>
+#include <QPair>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cstring>
+
+RuntimeExporter::RuntimeExporter(QObject *parent) :
+    AbstractExporter(parent)
+{
+    setExtension("fbr");
+}
+
+namespace {
+    const quint32 MaxDisplacement = 1u << 20;
+
+    /// little endian writer over a preallocated buffer
+    class Writer {
+    public:
+        Writer(QByteArray& out,uint pos) : m_data(reinterpret_cast<uchar*>(out.data())),m_pos(pos) {}
+        void u16(uint v) { qToLittleEndian<quint16>(quint16(v),m_data+m_pos); m_pos+=2; }
+        void i16(int v) { qToLittleEndian<qint16>(qint16(v),m_data+m_pos); m_pos+=2; }
+        void u32(uint v) { qToLittleEndian<quint32>(quint32(v),m_data+m_pos); m_pos+=4; }
+        void i32(int v) { qToLittleEndian<qint32>(qint32(v),m_data+m_pos); m_pos+=4; }
+        void str(const QByteArray& s) { ::memcpy(m_data+m_pos,s.constData(),s.size()); m_pos+=s.size()+1; }
+        uint pos() const { return m_pos; }
+    private:
+        uchar* m_data;
+        uint m_pos;
+    };
+
+    /// Hash and displace: keys are spread over buckets by fbr_hash(code,0),
+    /// the largest buckets search for a displacement first and single key
+    /// buckets take the remaining free slots directly.
+    bool buildPerfectHash(const QVector<uint>& codes,QVector<qint32>& buckets,QVector<int>& slots) {
+        const int count = codes.size();
+        const int bucket_count = count ? (count+3)/4 : 0;
+        buckets.fill(0,bucket_count);
+        slots.fill(-1,count);
+
+        QVector< QVector<int> > members(bucket_count);
+        for (int i=0;i<count;i++)
+            members[fbr_hash(codes[i],0)%bucket_count].push_back(i);
+        QVector< QPair<int,int> > order;
+        order.reserve(bucket_count);
+        for (int b=0;b<bucket_count;b++)
+            if (!members[b].isEmpty())
+                order.push_back(qMakePair(-members[b].size(),b));
+        qSort(order);
+
+        QVector<bool> taken(count,false);
+        int free_slot = 0;
+        QVarLengthArray<int,16> tried;
+        for (int i=0;i<order.size();i++) {
+            const int b = order[i].second;
+            const QVector<int>& keys = members[b];
+            if (keys.size()==1) {
+                while (taken[free_slot]) free_slot++;
+                taken[free_slot] = true;
+                slots[keys.front()] = free_slot;
+                buckets[b] = -free_slot-1;
+                continue;
+            }
+            quint32 d = 1;
+            for (;d<MaxDisplacement;d++) {
+                tried.clear();
+                for (int k=0;k<keys.size();k++) {
+                    const int s = fbr_hash(codes[keys[k]],d)%count;
+                    if (taken[s] || std::find(tried.begin(),tried.end(),s)!=tried.end())
+                        break;
+                    tried.append(s);
+                }
+                if (tried.size()==keys.size())
+                    break;
+            }
+            if (d==MaxDisplacement)
+                return false;
+            for (int k=0;k<keys.size();k++) {
+                taken[tried[k]] = true;
+                slots[keys[k]] = tried[k];
+            }
+            buckets[b] = qint32(d);
+        }
+        return true;
+    }
+}
+
+bool RuntimeExporter::Export(QByteArray& out) {
+    const QVector<Symbol>& syms = symbols();
+
+    // glyph rects are 16 bit
+    if (texWidth() > 0xffff || texHeight() > 0xffff) {
+        setErrorMessage("Texture too large for the runtime format");
+        return false;
+    }
+
+    QVector<uint> codes;
+    codes.reserve(syms.size());
+    foreach (const Symbol& c , syms) {
+        if (c.kerningCount > 0xffff) {
+            setErrorMessage("Too many kerning pairs for one glyph");
+            return false;
+        }
+        codes.push_back(c.id);
+    }
+    QVector<qint32> buckets;
+    QVector<int> slots;
+    if (!buildPerfectHash(codes,buckets,slots)) {
+        setErrorMessage("Failed to build glyph hash");
+        return false;
+    }
+
+    const KerningClasses* classes = kerningClasses();
+    if (classes && (classes->leftCount() > 0xffff || classes->rightCount() > 0xffff)) {
+        setErrorMessage("Too many kerning classes");
+        return false;
+    }
+    const int pair_count = classes ? 0 : kernings().size();
+    const int class_cells = classes ? classes->matrix().size() : 0;
+
+    const QByteArray texture = texFilename().toUtf8();
+    const QByteArray name = fontConfig()->family().toUtf8();
+
+    const uint buckets_offset = sizeof(fbr_header);
+    const uint glyphs_offset = buckets_offset + buckets.size()*sizeof(qint32);
+    const uint kernings_offset = glyphs_offset + syms.size()*sizeof(fbr_glyph);
+    const uint classes_offset = kernings_offset + pair_count*sizeof(fbr_kerning);
+    const uint texture_offset = classes_offset + class_cells*sizeof(qint32);
+    const uint name_offset = texture_offset + texture.size() + 1;
+    const uint size = (name_offset + name.size() + 1 + 3) & ~3u;
+
+    out.fill(0,size);
+
+    Writer header(out,0);
+    header.u32(FBR_MAGIC);
+    header.u32(FBR_VERSION);
+    header.u32(size);
+    header.u32(classes ? FBR_FLAG_KERNING_CLASSES : 0);
+    header.u32(syms.size());
+    header.u32(pair_count);
+    header.u32(buckets.size());
+    header.u32(buckets_offset);
+    header.u32(glyphs_offset);
+    header.u32(kernings_offset);
+    header.u32(classes ? classes->leftCount() : 0);
+    header.u32(classes ? classes->rightCount() : 0);
+    header.u32(classes_offset);
+    header.u32(texture_offset);
+    header.u32(name_offset);
+    header.i32(fontConfig()->size());
+    header.i32(metrics().ascender);
+    header.i32(metrics().descender);
+    header.i32(metrics().height);
+    header.u32(texWidth());
+    header.u32(texHeight());
+    header.i32(metrics().ascender64);
+    header.i32(metrics().descender64);
+    header.i32(metrics().height64);
+    Q_ASSERT(header.pos()==sizeof(fbr_header));
+
+    Writer table(out,buckets_offset);
+    foreach (qint32 d , buckets)
+        table.i32(d);
+
+    for (int i=0;i<syms.size();i++) {
+        const Symbol& c = syms[i];
+        Writer glyph(out,glyphs_offset + slots[i]*sizeof(fbr_glyph));
+        glyph.u32(c.id);
+        glyph.u16(c.placeX);
+        glyph.u16(c.placeY);
+        glyph.u16(c.placeW);
+        glyph.u16(c.placeH);
+        glyph.i16(c.offsetX);
+        glyph.i16(c.offsetY);
+        glyph.i32(c.advance64);
+        glyph.u32(classes ? 0 : c.kerningBegin);
+        glyph.u16(classes ? 0 : c.kerningCount);
+        glyph.u16(0);
+        glyph.u16(classes ? classes->leftClass(c.id) : 0);
+        glyph.u16(classes ? classes->rightClass(c.id) : 0);
+    }
+
+    if (classes) {
+        Writer matrix(out,classes_offset);
+        foreach (int amount , classes->matrix64())
+            matrix.i32(amount);
+    } else {
+        Writer pairs(out,kernings_offset);
+        foreach (const KerningPair& k , kernings()) {
+            pairs.u32(k.second);
+            pairs.i32(k.amount64);
+        }
+    }
+
+    Writer strings(out,texture_offset);
+    strings.str(texture);
+    strings.str(name);
+    return true;
+}
+
+
+AbstractExporter* RuntimeExporterFactoryFunc (QObject* parent) {
+    return new RuntimeExporter(parent);
+}
@@ -1,5 +1,6 @@
 #include "simpleexporter.h"
 #include "../fontconfig.h"
+#include "textwriter.h"
 
 SimpleExporter::SimpleExporter(QObject *parent) :
     AbstractExporter(parent)
@@ -12,44 +13,40 @@ bool SimpleExporter::Export(QByteArray &out)
     const FontConfig* cfg = fontConfig();
     int height = metrics().height;
 
+    const QVector<KerningPair> pairs = pixelKernings();
+    TextWriter w(out);
+    w.reserve(256 + symbols().size()*48 + pairs.size()*16);
     // Font family
-    out.append(cfg->family().toUtf8()).append('\n');
+    w << cfg->family() << '\n';
     // Font size
-    out.append(QString::number(cfg->size()).toUtf8()).append(' ');
+    w << cfg->size() << ' ';
     // Line height
-    out.append(QString::number(height).toUtf8()).append('\n');
+    w << height << '\n';
     // Texture filename
-    out.append(texFilename().toUtf8()).append('\n');
+    w << texFilename() << '\n';
     // Number of symbols
-    out.append(QString::number(symbols().size()).toUtf8()).append('\n');
+    w << symbols().size() << '\n';
     foreach(const Symbol& c , symbols()) {
         // id, x, y, width, height, xoffset, yoffset, xadvance
-        out.append(QString::number(c.id).toUtf8()).append(' ');
-        out.append(QString::number(c.placeX).toUtf8()).append(' ');
-        out.append(QString::number(c.placeY).toUtf8()).append(' ');
-        out.append(QString::number(c.placeW).toUtf8()).append(' ');
-        out.append(QString::number(c.placeH).toUtf8()).append(' ');
-        out.append(QString::number(c.offsetX).toUtf8()).append(' ');
-        out.append(QString::number(height - c.offsetY).toUtf8()).append(' ');
-        out.append(QString::number(c.advance).toUtf8()).append(' ');
-        out.append('\n');
-    }
-    QByteArray kernings;
-    int kerningsCount = 0;
-    typedef QMap<uint,int>::ConstIterator Kerning;
-    foreach(const Symbol& c , symbols()) {
-        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-            // first, second, amount
-            kernings.append(QString::number(c.id).toUtf8()).append(' ');
-            kernings.append(QString::number(k.key()).toUtf8()).append(' ');
-            kernings.append(QString::number(k.value()).toUtf8()).append(' ');
-            kernings.append('\n');
-            ++kerningsCount;
-        }
+        w << c.id << ' ';
+        w << c.placeX << ' ';
+        w << c.placeY << ' ';
+        w << c.placeW << ' ';
+        w << c.placeH << ' ';
+        w << c.offsetX << ' ';
+        w << height - c.offsetY << ' ';
+        w << c.advance << ' ';
+        w << '\n';
     }
     // Number of kernings
-    out.append(QString::number(kerningsCount).toUtf8()).append('\n');
-    out.append(kernings);
+    w << pairs.size() << '\n';
+    foreach(const KerningPair& k , pairs) {
+        // first, second, amount
+        w << k.first << ' ';
+        w << k.second << ' ';
+        w << k.amount << ' ';
+        w << '\n';
+    }
 
     return true;
 }
@@ -1,6 +1,6 @@
 #include "sparrowexporter.h"
 #include "../fontconfig.h"
-#include <QtXml>
+#include "xmlwriter.h"
 
 SparrowExporter::SparrowExporter(QObject *parent) :
     AbstractExporter(parent)
@@ -9,56 +9,58 @@ SparrowExporter::SparrowExporter(QObject *parent) :
 }
 
 bool SparrowExporter::Export(QByteArray& out) {
-    QDomDocument doc;
-    QDomElement root = doc.createElement("font");
-    doc.appendChild(root);
-    QDomElement info = doc.createElement("info");
-    root.appendChild(info);
-    info.setAttribute("face", fontConfig()->family());
-    info.setAttribute("size", fontConfig()->size());
-    QDomElement common = doc.createElement("common");
-    root.appendChild(common);
+    XmlWriter xml(out);
+    xml.startElement("font");
+
+    xml.startElement("info");
+    xml.attribute("face", fontConfig()->family());
+    xml.attribute("size", fontConfig()->size());
+    xml.endElement();
+
     int height = metrics().height;
-    common.setAttribute("lineHeight", height);
-    QDomElement pages = doc.createElement("pages");
-    root.appendChild(pages);
-    QDomElement page = doc.createElement("page");
-    pages.appendChild(page);
-    page.setAttribute("id", "0");
-    page.setAttribute("file", texFilename());
-    QDomElement chars = doc.createElement("chars");
-    root.appendChild(chars);
-    chars.setAttribute("count", symbols().size());
-    QDomElement kernings = doc.createElement("kernings");
-    int kernNumber = 0;
+    xml.startElement("common");
+    xml.attribute("lineHeight", height);
+    xml.endElement();
+
+    xml.startElement("pages");
+    xml.startElement("page");
+    xml.attribute("id", "0");
+    xml.attribute("file", texFilename());
+    xml.endElement();
+    xml.endElement();
+
+    xml.startElement("chars");
+    xml.attribute("count", symbols().size());
     foreach(const Symbol& c , symbols()) {
-        QDomElement ch = doc.createElement("char");
-        ch.setAttribute("id", QString::number(c.id));
-        ch.setAttribute("x", QString::number(c.placeX));
-        ch.setAttribute("y", QString::number(c.placeY));
-        ch.setAttribute("width", QString::number(c.placeW));
-        ch.setAttribute("height", QString::number(c.placeH));
-        ch.setAttribute("xoffset", QString::number(c.offsetX));
-        ch.setAttribute("yoffset", QString::number(height - c.offsetY));
-        ch.setAttribute("xadvance", QString::number(c.advance));
-        ch.setAttribute("page", "0");
-        ch.setAttribute("chnl", "0");
-        ch.setAttribute("letter", c.id==32 ? "space" : QString().append(c.id));
-        chars.appendChild(ch);
-        typedef QMap<uint,int>::ConstIterator Kerning;
-        for ( Kerning k = c.kerning.begin();k!=c.kerning.end();k++) {
-            QDomElement ker = doc.createElement("kerning");
-            ker.setAttribute("first", QString::number(c.id));
-            ker.setAttribute("second", QString::number(k.key()));
-            ker.setAttribute("amount", k.value());
-            kernings.appendChild(ker);
-            kernNumber ++;
-        }
+        xml.startElement("char");
+        xml.attribute("id", QString::number(c.id));
+        xml.attribute("x", c.placeX);
+        xml.attribute("y", c.placeY);
+        xml.attribute("width", c.placeW);
+        xml.attribute("height", c.placeH);
+        xml.attribute("xoffset", c.offsetX);
+        xml.attribute("yoffset", height - c.offsetY);
+        xml.attribute("xadvance", c.advance);
+        xml.attribute("page", "0");
+        xml.attribute("chnl", "0");
+        xml.attribute("letter", c.id==32 ? QString("space") : QString().append(c.id));
+        xml.endElement();
+    }
+    xml.endElement();
+
+    xml.startElement("kernings");
+    const QVector<KerningPair> pairs = pixelKernings();
+    xml.attribute("count", pairs.size());
+    foreach(const KerningPair& k , pairs) {
+        xml.startElement("kerning");
+        xml.attribute("first", QString::number(k.first));
+        xml.attribute("second", QString::number(k.second));
+        xml.attribute("amount", k.amount);
+        xml.endElement();
     }
-    kernings.setAttribute("count", QString::number(kernNumber));
-    root.appendChild(kernings);
+    xml.endElement();
 
-    out = doc.toByteArray(1);
+    xml.endElement();
     return true;
 }
 
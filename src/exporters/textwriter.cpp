@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "textwriter.h"
+
+static inline char* formatUnsigned(char* end,uint value) {
+    do {
+        *--end = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return end;
+}
+
+TextWriter& TextWriter::operator<<(uint value) {
+    char buf[16];
+    char* end = buf+sizeof(buf);
+    char* begin = formatUnsigned(end,value);
+    m_out.append(begin,int(end-begin));
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(int value) {
+    char buf[16];
+    char* end = buf+sizeof(buf);
+    char* begin = formatUnsigned(end,value<0 ? 0u-uint(value) : uint(value));
+    if (value<0)
+        *--begin = '-';
+    m_out.append(begin,int(end-begin));
+    return *this;
+}
+
+TextWriter& TextWriter::number(double value,char format,int precision) {
+    // QByteArray::number is locale independent, unlike printf
+    m_out.append(QByteArray::number(value,format,precision));
+    return *this;
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TEXTWRITER_H
+#define TEXTWRITER_H
+
+#include <QByteArray>
+#include <QString>
+
+/// Appends text straight into the output buffer. Integers are formatted
+/// in place, ASCII needs no conversion, QString goes out as utf-8.
+class TextWriter
+{
+public:
+    explicit TextWriter(QByteArray& out) : m_out(out) {}
+
+    TextWriter& operator<<(char c) { m_out.append(c); return *this;}
+    TextWriter& operator<<(const char* str) { m_out.append(str); return *this;}
+    TextWriter& operator<<(const QByteArray& str) { m_out.append(str); return *this;}
+    TextWriter& operator<<(const QString& str) { m_out.append(str.toUtf8()); return *this;}
+    TextWriter& operator<<(int value);
+    TextWriter& operator<<(uint value);
+    /// same text as QString::number(value,format,precision)
+    TextWriter& number(double value,char format = 'g',int precision = 6);
+
+    void reserve(int size) { m_out.reserve(m_out.size()+size);}
+private:
+    QByteArray& m_out;
+};
+
+#endif // TEXTWRITER_H
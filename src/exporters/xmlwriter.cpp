@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "xmlwriter.h"
+#include "textwriter.h"
+#include <cstring>
+
+XmlWriter::XmlWriter(QByteArray& out) : m_out(out),m_start_open(false)
+{
+}
+
+XmlWriter::~XmlWriter() {
+    while (!m_stack.isEmpty())
+        endElement();
+}
+
+void XmlWriter::writeDeclaration() {
+    m_out.append("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+}
+
+void XmlWriter::indent() {
+    for (int i=0;i<m_stack.size();i++)
+        m_out.append(' ');
+}
+
+void XmlWriter::closeStartTag() {
+    if (m_start_open) {
+        m_out.append(">\n");
+        m_start_open = false;
+    }
+}
+
+void XmlWriter::startElement(const char* name) {
+    closeStartTag();
+    indent();
+    m_out.append('<').append(name);
+    m_stack.push_back(name);
+    m_start_open = true;
+}
+
+void XmlWriter::endElement() {
+    const char* name = m_stack.back();
+    m_stack.pop_back();
+    if (m_start_open) {
+        m_out.append("/>\n");
+        m_start_open = false;
+    } else {
+        indent();
+        m_out.append("</").append(name).append(">\n");
+    }
+}
+
+/// same entities as QDom uses for attribute values
+void XmlWriter::escape(const char* value,int size) {
+    const char* begin = value;
+    for (int i=0;i<size;i++) {
+        const char* entity = 0;
+        switch (value[i]) {
+        case '<':  entity = "&lt;"; break;
+        case '"':  entity = "&quot;"; break;
+        case '&':  entity = "&amp;"; break;
+        case '>':
+            if (i>=2 && value[i-1]==']' && value[i-2]==']')
+                entity = "&gt;";
+            break;
+        case '\n': entity = "&#xa;"; break;
+        case '\r': entity = "&#xd;"; break;
+        case '\t': entity = "&#x9;"; break;
+        default: break;
+        }
+        if (entity) {
+            m_out.append(begin,int(value+i-begin));
+            m_out.append(entity);
+            begin = value+i+1;
+        }
+    }
+    m_out.append(begin,int(value+size-begin));
+}
+
+void XmlWriter::attribute(const char* name,const char* value) {
+    m_out.append(' ').append(name).append("=\"");
+    escape(value,int(::strlen(value)));
+    m_out.append('"');
+}
+
+void XmlWriter::attribute(const char* name,const QString& value) {
+    const QByteArray utf8 = value.toUtf8();
+    m_out.append(' ').append(name).append("=\"");
+    escape(utf8.constData(),utf8.size());
+    m_out.append('"');
+}
+
+void XmlWriter::attribute(const char* name,int value) {
+    m_out.append(' ').append(name).append("=\"");
+    TextWriter(m_out) << value;
+    m_out.append('"');
+}
+
+void XmlWriter::attribute(const char* name,float value) {
+    // QDomElement::setAttribute(float) precision
+    m_out.append(' ').append(name).append("=\"");
+    TextWriter(m_out).number(value,'g',8);
+    m_out.append('"');
+}
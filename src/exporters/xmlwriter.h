@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLWRITER_H
+#define XMLWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/// Forward-only XML writer appending straight into the output buffer.
+/// Formats like QDomDocument::toByteArray(1) without building a tree.
+class XmlWriter
+{
+public:
+    explicit XmlWriter(QByteArray& out);
+    ~XmlWriter();
+
+    void writeDeclaration();
+    void startElement(const char* name);
+    void endElement();
+
+    void attribute(const char* name,const char* value);
+    void attribute(const char* name,const QString& value);
+    void attribute(const char* name,int value);
+    void attribute(const char* name,float value);
+private:
+    void closeStartTag();
+    void indent();
+    void escape(const char* value,int size);
+
+    QByteArray& m_out;
+    QVector<const char*> m_stack;
+    bool    m_start_open;
+};
+
+#endif // XMLWRITER_H
@@ -0,0 +1,476 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "exportjob.h"
+#include "fontconfig.h"
+#include "fontrenderer.h"
+#include "layoutconfig.h"
+#include "layoutdata.h"
+#include "outputconfig.h"
+#include "layouterfactory.h"
+#include "abstractexporter.h"
+#include "abstractimagewriter.h"
+#include "atomicfile.h"
+#include "rendercache.h"
+#include "fontfile.h"
+#include "perf.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QMetaProperty>
+#include <QMutexLocker>
+#include <QRegExp>
+#include <QDebug>
+#include <QtConcurrentRun>
+
+static void copyConfig(const QObject* from,QObject* to) {
+    const QMetaObject *metaobject = from->metaObject();
+    int count = metaobject->propertyCount();
+    for (int i=0; i<count; ++i) {
+        QMetaProperty metaproperty = metaobject->property(i);
+        if (!metaproperty.isWritable())
+            continue;
+        const char *name = metaproperty.name();
+        to->setProperty(name,from->property(name));
+    }
+}
+
+ExportJob::ExportJob(QObject *parent) :
+    QObject(parent), m_has_data(false), m_render_cache(0),
+    m_skip_unchanged(false), m_skipped(false), m_cancel(0), m_progress(0), m_progress_max(0)
+{
+    m_font_config = new FontConfig(this);
+    m_layout_config = new LayoutConfig(this);
+    m_output_config = new OutputConfig(this);
+    m_layout_data = new LayoutData(this);
+    connect(&m_watcher,SIGNAL(finished()),this,SLOT(onFinished()));
+}
+
+ExportJob::~ExportJob() {
+    cancel();
+    m_watcher.waitForFinished();
+    releaseRenderCache();
+    foreach (const Pass& pass, m_passes) {
+        foreach (const ImageOutput& output, pass.images)
+            delete output.writer;
+        foreach (const DescriptionOutput& output, pass.descriptions)
+            delete output.exporter;
+    }
+    qDeleteAll(m_files);
+}
+
+void ExportJob::setConfig(const FontConfig* font,const LayoutConfig* layout,const OutputConfig* output) {
+    copyConfig(font,m_font_config);
+    copyConfig(layout,m_layout_config);
+    copyConfig(output,m_output_config);
+}
+
+void ExportJob::setData(const LayoutData* data,const RendererData& rendered) {
+    m_layout_data->resize(data->width(),data->height());
+    m_layout_data->beginPlacing();
+    foreach (const LayoutChar& c, data->placed())
+        m_layout_data->placeChar(c);
+    m_layout_data->endPlacing();
+    m_layout_data->setImage(data->image(),data->imageOrigin());
+    m_rendered = rendered;
+    m_has_data = true;
+}
+
+void ExportJob::addPass(float scale) {
+    Pass pass;
+    pass.scale = scale;
+    pass.reserved = false;
+    if (scale!=1.0f)
+        pass.suffix = QString("_x%1").arg(scale);
+    m_passes.push_back(pass);
+}
+
+void ExportJob::setRenderCache(RenderCache* cache) {
+    releaseRenderCache();
+    m_render_cache = cache;
+    if (!m_render_cache)
+        return;
+    for (int i=0;i<m_passes.size();i++) {
+        Pass& pass = m_passes[i];
+        /// the same passes runPass renders without the cache
+        if (pass.scale==1.0f && (m_has_data || !m_locked.chars.isEmpty()))
+            continue;
+        m_render_cache->reserve(m_font_config,pass.scale);
+        pass.reserved = true;
+    }
+}
+
+/// uses left by passes that did not render, so the cache can drop them
+void ExportJob::releaseRenderCache() {
+    for (int i=0;i<m_passes.size();i++) {
+        if (m_passes[i].reserved) {
+            m_render_cache->release(m_font_config,m_passes[i].scale);
+            m_passes[i].reserved = false;
+        }
+    }
+}
+
+/// formats sharing an extension get the format name appended
+QString ExportJob::outputName(Pass& pass,const QString& base,const QString& format,const QString& extension) {
+    QString name = base+pass.suffix+"."+extension;
+    if (pass.names.contains(name)) {
+        QString tag = format.toLower();
+        tag.replace(QRegExp("[^a-z0-9]+"),"_");
+        tag.remove(QRegExp("^_+|_+$"));
+        name = base+pass.suffix+"_"+tag+"."+extension;
+    }
+    pass.names.push_back(name);
+    return name;
+}
+
+void ExportJob::addImageWriter(const QString& format,AbstractImageWriter* writer) {
+    Pass& pass = m_passes.back();
+    ImageOutput output;
+    output.writer = writer;
+    output.name = outputName(pass,m_output_config->imageName(),format,writer->extension());
+    output.file = QDir(m_output_config->path()).filePath(output.name);
+    pass.images.push_back(output);
+}
+
+void ExportJob::addExporter(const QString& format,AbstractExporter* exporter) {
+    Pass& pass = m_passes.back();
+    DescriptionOutput output;
+    output.exporter = exporter;
+    output.format = format;
+    output.file = QDir(m_output_config->path()).filePath(
+                outputName(pass,m_output_config->descriptionName(),format,exporter->getExtension()));
+    pass.descriptions.push_back(output);
+}
+
+void ExportJob::start() {
+    m_watcher.setFuture(QtConcurrent::run(this,&ExportJob::run));
+}
+
+void ExportJob::cancel() {
+    m_cancel.fetchAndStoreOrdered(1);
+}
+
+bool ExportJob::isCancelled() const {
+    return m_cancel.fetchAndAddOrdered(0)!=0;
+}
+
+void ExportJob::onFinished() {
+    finished(m_watcher.result());
+}
+
+void ExportJob::step() {
+    int value = m_progress.fetchAndAddOrdered(1)+1;
+    progress(value,m_progress_max);
+}
+
+void ExportJob::setError(const QString& error) {
+    QMutexLocker lock(&m_error_mutex);
+    if (m_error_string.isEmpty())
+        m_error_string = error;
+}
+
+AbstractImageWriter* ExportJob::takeImageWriter() {
+    for (int i=0;i<m_passes.size();i++) {
+        if (m_passes[i].scale==1.0f && !m_passes[i].images.isEmpty()) {
+            ImageOutput& output = m_passes[i].images.front();
+            AbstractImageWriter* writer = output.writer;
+            output.writer = 0;
+            m_image_file = output.file;
+            return writer;
+        }
+    }
+    return 0;
+}
+
+QVector<ExportJob::WrittenDescription> ExportJob::writtenDescriptions() const {
+    QVector<WrittenDescription> result;
+    foreach (const Pass& pass, m_passes) {
+        foreach (const DescriptionOutput& output, pass.descriptions) {
+            WrittenDescription written;
+            written.format = output.format;
+            written.file = output.file;
+            written.exporter = output.exporter;
+            result.push_back(written);
+        }
+    }
+    return result;
+}
+
+QVector<QSize> ExportJob::atlasSizes() const {
+    QVector<QSize> result;
+    foreach (const Pass& pass, m_passes)
+        result.push_back(pass.atlas);
+    return result;
+}
+
+/// bump when rendering or any output format changes for the same inputs
+static const char* ExportRevision = "fontbuilder-export-1";
+
+static void hashConfig(QDataStream& s,const QObject* object) {
+    const QMetaObject *metaobject = object->metaObject();
+    for (int i=0;i<metaobject->propertyCount();i++) {
+        const char* name = metaobject->property(i).name();
+        s << QByteArray(name) << object->property(name);
+    }
+}
+
+QByteArray ExportJob::inputHash() const {
+    QSharedPointer<FontFile> font = FontFile::open(
+                QDir(m_font_config->path()).filePath(m_font_config->filename()));
+    if (!font)
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char*>(font->data()),int(font->size()));
+
+    QByteArray inputs;
+    QBuffer buffer(&inputs);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream s(&buffer);
+    s << QByteArray(ExportRevision) << QByteArray(qVersion())
+      << qint32(FREETYPE_MAJOR) << qint32(FREETYPE_MINOR) << qint32(FREETYPE_PATCH);
+    hashConfig(s,m_font_config);
+    hashConfig(s,m_layout_config);
+    hashConfig(s,m_output_config);
+    s << m_layouter;
+    for (QMap<uint,RenderedChar>::ConstIterator it = m_locked.chars.begin();it!=m_locked.chars.end();++it)
+        s << it.key() << qint32(it->offsetX) << qint32(it->offsetY) << qint32(it->advance64)
+          << it->img << it->kerning << it->kerning64;
+    foreach (const Pass& pass, m_passes) {
+        s << pass.scale;
+        foreach (const ImageOutput& output, pass.images)
+            s << output.file;
+        foreach (const DescriptionOutput& output, pass.descriptions)
+            s << output.format << output.file;
+    }
+    hash.addData(inputs);
+    return hash.result().toHex();
+}
+
+QString ExportJob::hashFile() const {
+    QString name = m_output_config->writeDescription() ?
+                m_output_config->descriptionName() : m_output_config->imageName();
+    return QDir(m_output_config->path()).filePath(name+".fbhash");
+}
+
+bool ExportJob::outputsExist() const {
+    foreach (const Pass& pass, m_passes) {
+        foreach (const ImageOutput& output, pass.images)
+            if (!QFileInfo(output.file).exists()) return false;
+        foreach (const DescriptionOutput& output, pass.descriptions)
+            if (!QFileInfo(output.file).exists()) return false;
+    }
+    return true;
+}
+
+bool ExportJob::run() {
+    m_skipped = false;
+    QByteArray hash;
+    if (m_skip_unchanged && !m_has_data) {
+        hash = inputHash();
+        QFile stored(hashFile());
+        if (!hash.isEmpty() && outputsExist() && stored.open(QFile::ReadOnly)
+                && stored.readAll().trimmed()==hash) {
+            /// outputs are left untouched, so their mtimes stay too
+            m_skipped = true;
+            releaseRenderCache();
+            return true;
+        }
+    }
+
+    m_progress_max = 0;
+    foreach (const Pass& pass, m_passes) {
+        m_progress_max+=pass.images.size()+pass.descriptions.size();
+        if (pass.scale!=1.0f || !m_has_data) m_progress_max++;
+    }
+    QList<QFuture<bool> > passes;
+    for (int i=0;i<m_passes.size();i++)
+        passes.push_back(QtConcurrent::run(this,&ExportJob::runPass,&m_passes[i]));
+    bool ok = true;
+    for (int i=0;i<passes.size();i++)
+        ok = passes[i].result() && ok;
+    releaseRenderCache();
+    ok = ok && !isCancelled() && commitFiles();
+    qDeleteAll(m_files);
+    m_files.clear();
+    if (ok && !hash.isEmpty()) {
+        AtomicFile file(hashFile());
+        if (!file.open(QIODevice::WriteOnly) || file.write(hash+"\n")!=hash.size()+1 || !file.commit())
+            qDebug() << "failed write" << hashFile();
+    }
+    return ok;
+}
+
+void ExportJob::addFile(AtomicFile* file) {
+    QMutexLocker lock(&m_files_mutex);
+    m_files.push_back(file);
+}
+
+bool ExportJob::commitFiles() {
+    foreach (AtomicFile* file, m_files) {
+        if (!file->commit()) {
+            setError(tr("Error writing file :")+file->targetName()+"\n"+file->errorString());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ExportJob::runPass(Pass* pass) {
+    if (isCancelled())
+        return false;
+    PerfTimer timer("export pass");
+    /// interactive state already holds the 1x render, including locked glyphs
+    const bool interactive = pass->scale==1.0f && m_has_data;
+    /// locked glyphs exist at 1x only and are not part of the cache key
+    const bool locked = !interactive && pass->scale==1.0f && !m_locked.chars.isEmpty();
+    /// the font is opened only to render here or for formats reading the face
+    FontRenderer renderer(0,m_font_config);
+    if ((!interactive && (locked || !m_render_cache)) || needsFace(*pass))
+        renderer.open(pass->scale);
+    if (interactive)
+        return exportPass(pass,m_layout_data,m_rendered,renderer.face());
+    QSharedPointer<const RenderCache::Entry> cached;
+    if (locked) {
+        renderer.LoadLocked(m_locked);
+        renderer.render(pass->scale);
+    } else if (m_render_cache) {
+        cached = m_render_cache->render(m_font_config,pass->scale);
+        pass->reserved = false;
+    }
+    else
+        renderer.render(pass->scale);
+    const RendererData& rendered = cached ? cached->data : renderer.data();
+    step();
+    if (isCancelled())
+        return false;
+    LayouterFactory factory;
+    AbstractLayouter* layouter = factory.build(m_layouter,0);
+    if (!layouter) {
+        setError(tr("Unknown layouter :")+m_layouter);
+        return false;
+    }
+    LayoutData layout;
+    layouter->setConfig(m_layout_config);
+    layouter->setData(&layout);
+    layouter->on_ReplaceImages(cached ? cached->chars : renderer.rendered());
+    delete layouter;
+    return exportPass(pass,&layout,rendered,renderer.face());
+}
+
+bool ExportJob::needsFace(const Pass& pass) {
+    foreach (const DescriptionOutput& output, pass.descriptions)
+        if (output.exporter->needsFace())
+            return true;
+    return false;
+}
+
+bool ExportJob::exportPass(Pass* pass,const LayoutData* layout,const RendererData& rendered,FT_Face face) {
+    pass->atlas = QSize(layout->width(),layout->height());
+    QList<QFuture<bool> > outputs;
+    /// the interactive atlas is already composited, other scales and atlases
+    /// reloaded from an edited image are built once here
+    QImage atlas;
+    if (!pass->images.isEmpty()) {
+        if (layout->imageOrigin()==LayoutData::ImageComposited)
+            atlas = layout->image();
+        if (atlas.isNull() || atlas.width()!=layout->width() || atlas.height()!=layout->height())
+            atlas = AbstractImageWriter::buildImage(layout,m_layout_config,rendered);
+        for (int i=0;i<pass->images.size();i++)
+            outputs.push_back(QtConcurrent::run(this,&ExportJob::writeImage,pass->images.constData()+i,layout,&rendered,&atlas));
+    }
+    /// symbol table is built once and shared by every format
+    const QString texture = pass->images.isEmpty() ? QString() : pass->images.front().name;
+    AbstractExporter* first = 0;
+    for (int i=0;i<pass->descriptions.size() && !isCancelled();i++) {
+        AbstractExporter* exporter = pass->descriptions[i].exporter;
+        exporter->setFace(face);
+        exporter->setFontConfig(m_font_config,m_layout_config);
+        if (first)
+            exporter->copyData(first);
+        else
+            exporter->setData(layout,rendered);
+        first = exporter;
+        exporter->setTextureFilename(texture);
+        exporter->setScale(pass->scale);
+        exporter->setKerningClasses(m_output_config->kerningClasses());
+        outputs.push_back(QtConcurrent::run(this,&ExportJob::writeDescription,pass->descriptions.constData()+i));
+    }
+    bool ok = true;
+    for (int i=0;i<outputs.size();i++)
+        ok = outputs[i].result() && ok;
+    return ok;
+}
+
+bool ExportJob::writeDescription(const DescriptionOutput* output) {
+    if (isCancelled())
+        return false;
+    AbstractExporter* exporter = output->exporter;
+    QByteArray data;
+    bool ok = true;
+    if (!exporter->Write(data)) {
+        setError(tr("Error on save description :\n")+exporter->getErrorString()+"\nFile not writed.");
+        ok = false;
+    } else {
+        AtomicFile* file = new AtomicFile(output->file);
+        addFile(file);
+        if (!file->open(QIODevice::WriteOnly)) {
+            setError(tr("Error opening file :")+output->file);
+            ok = false;
+        } else if (file->write(data)!=data.size()) {
+            setError(tr("Error writing file :")+output->file+"\n"+file->errorString());
+            ok = false;
+        }
+    }
+    step();
+    return ok;
+}
+
+bool ExportJob::writeImage(const ImageOutput* output,const LayoutData* layout,const RendererData* rendered,const QImage* atlas) {
+    if (isCancelled())
+        return false;
+    AbstractImageWriter* writer = output->writer;
+    writer->setData(layout,m_layout_config,*rendered);
+    AtomicFile* file = new AtomicFile(output->file);
+    addFile(file);
+    bool ok = true;
+    if (!file->open(QIODevice::WriteOnly)) {
+        setError(tr("Error opening file :")+output->file);
+        ok = false;
+    } else if (!writer->Write(*file,AtlasView(*atlas))) {
+        setError(tr("Error on save image :\n")+writer->errorString()+"\nFile not writed.");
+        ok = false;
+    }
+    step();
+    return ok;
+}
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef EXPORTJOB_H
+#define EXPORTJOB_H
+
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QFutureWatcher>
+#include <QSize>
+
+#include "rendererdata.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+class FontConfig;
+class LayoutConfig;
+class LayoutData;
+class OutputConfig;
+class AbstractExporter;
+class AbstractImageWriter;
+class AtomicFile;
+class RenderCache;
+class QImage;
+
+/// Self-contained export of one font. All inputs are copied on the
+/// GUI thread, so run() may execute on a worker thread while the
+/// interactive state keeps changing. Every output scale is a pass
+/// with its own renderer and layouter; passes and the formats inside
+/// a pass run in parallel. Files replace their targets only after
+/// every output has been written. Without setData() every pass,
+/// 1x included, is rendered from the font file.
+class ExportJob : public QObject
+{
+Q_OBJECT
+public:
+    explicit ExportJob(QObject *parent = 0);
+    ~ExportJob();
+
+    void setConfig(const FontConfig* font,const LayoutConfig* layout,const OutputConfig* output);
+    void setData(const LayoutData* data,const RendererData& rendered);
+    void setLayouter(const QString& name) { m_layouter = name;}
+    /// glyphs kept over the font file render of the 1x pass, e.g. from a project
+    void setLocked(const RendererData& locked) { m_locked = locked;}
+    /// renders of passes are shared through the cache, not owned; reserves
+    /// the renders of the passes added so far until run() takes them
+    void setRenderCache(RenderCache* cache);
+    /// skip run() when the inputs hash to what the last export stored
+    /// next to its outputs; only for jobs that render from the font file
+    void setSkipUnchanged(bool skip) { m_skip_unchanged = skip;}
+    bool skipped() const { return m_skipped;}
+    void addPass(float scale);
+    /// take ownership of writer/exporter, output of the last added pass
+    void addImageWriter(const QString& format,AbstractImageWriter* writer);
+    void addExporter(const QString& format,AbstractExporter* exporter);
+
+    void start();
+    bool run();
+    bool isRunning() const { return m_watcher.isRunning();}
+    bool isCancelled() const;
+
+    const QString& errorString() const { return m_error_string;}
+    /// image writer of the 1x pass and the file it wrote, for reload watching
+    AbstractImageWriter* takeImageWriter();
+    const QString& imageFile() const { return m_image_file;}
+
+    struct WrittenDescription {
+        QString format;
+        QString file;
+        const AbstractExporter* exporter;
+    };
+    /// description outputs of every pass, with the tables they were written from
+    QVector<WrittenDescription> writtenDescriptions() const;
+    /// atlas size of every pass, valid after run()
+    QVector<QSize> atlasSizes() const;
+signals:
+    void progress(int value,int maximum);
+    void finished(bool ok);
+public slots:
+    void cancel();
+private:
+    struct ImageOutput {
+        AbstractImageWriter* writer;
+        QString name;
+        QString file;
+    };
+    struct DescriptionOutput {
+        AbstractExporter* exporter;
+        QString format;
+        QString file;
+    };
+    struct Pass {
+        float scale;
+        QString suffix;
+        QVector<ImageOutput> images;
+        QVector<DescriptionOutput> descriptions;
+        QStringList names;
+        QSize atlas;
+        bool reserved;      ///< holds a render cache use
+    };
+    FontConfig* m_font_config;
+    LayoutConfig* m_layout_config;
+    OutputConfig* m_output_config;
+    LayoutData* m_layout_data;
+    RendererData m_rendered;
+    bool m_has_data;
+    RendererData m_locked;
+    RenderCache* m_render_cache;
+    bool m_skip_unchanged;
+    bool m_skipped;
+    QString m_layouter;
+    QVector<Pass> m_passes;
+    QString m_error_string;
+    QString m_image_file;
+    QMutex m_error_mutex;
+    QList<AtomicFile*> m_files;
+    QMutex m_files_mutex;
+    mutable QAtomicInt m_cancel;
+    QAtomicInt m_progress;
+    int m_progress_max;
+    QFutureWatcher<bool> m_watcher;
+
+    bool runPass(Pass* pass);
+    static bool needsFace(const Pass& pass);
+    bool exportPass(Pass* pass,const LayoutData* layout,const RendererData& rendered,FT_Face face);
+    bool writeImage(const ImageOutput* output,const LayoutData* layout,const RendererData* rendered,const QImage* atlas);
+    bool writeDescription(const DescriptionOutput* output);
+    QString outputName(Pass& pass,const QString& base,const QString& format,const QString& extension);
+    void addFile(AtomicFile* file);
+    bool commitFiles();
+    void releaseRenderCache();
+    QByteArray inputHash() const;
+    QString hashFile() const;
+    bool outputsExist() const;
+    void step();
+    void setError(const QString& error);
+private slots:
+    void onFinished();
+};
+
+#endif // EXPORTJOB_H
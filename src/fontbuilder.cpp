@@ -39,9 +39,11 @@
 #include <QDir>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QProgressDialog>
+#include <QProgressBar>
+#include <QStatusBar>
 
 #include "fontconfig.h"
-#include "fontrenderer.h"
 #include "layoutconfig.h"
 #include "layoutdata.h"
 #include "layouterfactory.h"
@@ -49,12 +51,21 @@
 #include "exporterfactory.h"
 #include "imagewriterfactory.h"
 #include "fontloader.h"
+#include "exportjob.h"
+#include "projectfile.h"
+#include "rebuildscheduler.h"
+#include "perf.h"
+#include "perfdialog.h"
 
 
 FontBuilder::FontBuilder(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::FontBuilder),
-    m_image_writer(0)
+    m_image_writer(0),
+    m_export_job(0),
+    m_export_progress(0),
+    m_perf_dialog(0),
+    m_export_queued(false)
 {
     ui->setupUi(this);
 
@@ -65,16 +76,22 @@ FontBuilder::FontBuilder(QWidget *parent) :
     connect(m_font_config,SIGNAL(nameChanged()),this,SLOT(onFontNameChanged()));
     connect(m_font_config,SIGNAL(sizeChanged()),this,SLOT(onFontNameChanged()));
 
-    m_font_renderer = new FontRenderer(this,m_font_config);
-
-    connect(m_font_renderer,SIGNAL(imagesChanged()),this,SLOT(onRenderedChanged()));
-
     m_layout_config = new LayoutConfig(this);
     m_layout_data = new LayoutData(this);
 
     connect(m_layout_data,SIGNAL(layoutChanged()),this,SLOT(onLayoutChanged()));
 
-    m_layouter = 0;
+    /// renders, lays out and composites in the background
+    m_scheduler = new RebuildScheduler(this,m_font_config,m_layout_config,m_layout_data);
+    connect(m_scheduler,SIGNAL(renderFinished()),this,SLOT(onRenderedChanged()));
+    m_rebuild_progress = new QProgressBar(this);
+    m_rebuild_progress->setMaximumWidth(240);
+    m_rebuild_progress->hide();
+    statusBar()->addPermanentWidget(m_rebuild_progress);
+    connect(m_scheduler,SIGNAL(progress(int,int)),this,SLOT(onRebuildProgress(int,int)));
+    connect(m_scheduler,SIGNAL(finished()),m_rebuild_progress,SLOT(hide()));
+    connect(m_scheduler,SIGNAL(finished()),this,SLOT(onRebuildFinished()));
+
     m_layouter_factory = new LayouterFactory(this);
 
     bool b = ui->comboBoxLayouter->blockSignals(true);
@@ -117,11 +134,11 @@ FontBuilder::FontBuilder(QWidget *parent) :
     ui->frameFontSelect->setConfig(m_font_config);
 
     ui->fontTestFrame->setLayoutData(m_layout_data);
-    ui->fontTestFrame->setRendererData(&m_font_renderer->data());
+    ui->fontTestFrame->setRendererData(&m_scheduler->data());
     ui->fontTestFrame->setFontConfig(m_font_config);
 
     ui->widgetFontPreview->setLayoutData(m_layout_data);
-    ui->widgetFontPreview->setRendererData(&m_font_renderer->data());
+    ui->widgetFontPreview->setRendererData(&m_scheduler->data());
     ui->widgetFontPreview->setLayoutConfig(m_layout_config);
 
     m_font_config->blockSignals(font_config_block);
@@ -199,19 +216,9 @@ void FontBuilder::fontParametersChanged() {
 void FontBuilder::on_comboBoxLayouter_currentIndexChanged(QString name)
 {
     if (name.isEmpty()) return;
-    if (m_layouter) {
-        delete m_layouter;
-        m_layouter = 0;
-    }
-    m_layouter = m_layouter_factory->build(name,this);
-    if (m_layouter) {
-        m_layouter->setConfig(m_layout_config);
-        m_layouter->setData(m_layout_data);
-        connect(m_font_renderer,SIGNAL(imagesChanged(QVector<LayoutChar>)),
-                m_layouter,SLOT(on_ReplaceImages(QVector<LayoutChar>)));
-        m_layouter->on_ReplaceImages(m_font_renderer->rendered());
-        m_layout_config->setLayouter(name);
-    }
+    if (!m_layouter_factory->names().contains(name)) return;
+    m_layout_config->setLayouter(name);
+    m_scheduler->scheduleLayout();
 }
 
 void FontBuilder::onRenderedChanged() {
@@ -230,20 +237,9 @@ void FontBuilder::setLayoutImage(const QImage& image) {
 }
 
 void FontBuilder::onLayoutChanged() {
-    QImage image (m_layout_data->width(),m_layout_data->height(),QImage::Format_ARGB32);
-    image.fill(0);
-    {
-        QPainter painter(&image);
-        foreach (const LayoutChar& c,m_layout_data->placed()) {
-            m_font_renderer->placeImage(painter,c.symbol,
-                                        c.x + m_layout_config->offsetLeft(),
-                                        c.y + m_layout_config->offsetTop()
-                                        );
-        }
-    }
-    qDebug() << "set layout image from rendered";
-    m_layout_data->setImage(image);
-    setLayoutImage(image);
+    PerfTimer timer("preview update");
+    /// composited by the scheduler like the image writers do, so export can stream it as is
+    setLayoutImage(m_layout_data->image());
     ui->fontTestFrame->refresh();
     if (m_image_writer)
         m_image_writer->forget();
@@ -265,91 +261,111 @@ void FontBuilder::onFontNameChanged() {
         m_image_writer->forget();
 }
 
-void FontBuilder::doExport(bool x2) {
-    QDir dir(m_output_config->path());
-    QString texture_filename;
-    setLayoutImage(m_layout_data->image());
+bool FontBuilder::addExportPass(ExportJob* job,float scale) {
+    job->addPass(scale);
     if (m_output_config->writeImage()) {
-        delete m_image_writer;
-        m_image_writer = 0;
-        AbstractImageWriter* exporter = m_image_writer_factory->build(m_output_config->imageFormat(),this);
-        if (!exporter) {
-            QMessageBox msgBox;
-            msgBox.setText(tr("Unknown exporter :")+m_output_config->descriptionFormat());
-            msgBox.exec();
-            return;
+        foreach (const QString& format, m_output_config->imageFormats()) {
+            AbstractImageWriter* writer = m_image_writer_factory->build(format,0);
+            if (!writer) {
+                QMessageBox msgBox;
+                msgBox.setText(tr("Unknown exporter :")+format);
+                msgBox.exec();
+                return false;
+            }
+            job->addImageWriter(format,writer);
         }
-
-        exporter->setData(m_layout_data,m_layout_config,m_font_renderer->data());
-        texture_filename = m_output_config->imageName();
-        if (x2) {
-            texture_filename += "_x2";
-        }
-        texture_filename+="."+exporter->extension();
-        QString filename = dir.filePath(texture_filename);
-
-        QFile file(this);
-        file.setFileName(filename);
-        if (!file.open(QIODevice::WriteOnly)) {
-            delete exporter;
-            QMessageBox msgBox;
-            msgBox.setText(tr("Error opening file :")+filename);
-            msgBox.exec();
-            return;
-        }
-        if (!exporter->Write(file)) {
-            QMessageBox msgBox;
-            msgBox.setText(tr("Error on save image :\n")+exporter->errorString()+"\nFile not writed.");
-            msgBox.exec();
-        }
-        file.close();
-        m_image_writer = exporter;
-        m_image_writer->watch(filename);
-        connect(m_image_writer,SIGNAL(imageChanged(QString)),this,SLOT(onExternalImageChanged(QString)));
     }
     if (m_output_config->writeDescription()) {
-        AbstractExporter* exporter = m_exporter_factory->build(m_output_config->descriptionFormat(),this);
-        if (!exporter) {
-            QMessageBox msgBox;
-            msgBox.setText(tr("Unknown exporter :")+m_output_config->descriptionFormat());
-            msgBox.exec();
-            return;
+        foreach (const QString& format, m_output_config->descriptionFormats()) {
+            AbstractExporter* exporter = m_exporter_factory->build(format,0);
+            if (!exporter) {
+                QMessageBox msgBox;
+                msgBox.setText(tr("Unknown exporter :")+format);
+                msgBox.exec();
+                return false;
+            }
+            job->addExporter(format,exporter);
         }
-        exporter->setFace(m_font_renderer->face());
-        exporter->setFontConfig(m_font_config,m_layout_config);
-        exporter->setData(m_layout_data,m_font_renderer->data());
-        exporter->setTextureFilename(texture_filename);
-        exporter->setScale(m_font_renderer->scale());
-        QString filename = dir.filePath(m_output_config->descriptionName());
-        if (x2) {
-            filename += "_x2";
-        }
-        filename+="."+exporter->getExtension();
-        QByteArray data;
-        if (!exporter->Write(data)) {
-             QMessageBox msgBox;
-             msgBox.setText(tr("Error on save description :\n")+exporter->getErrorString()+"\nFile not writed.");
-             msgBox.exec();
-         } else {
-             QFile file(filename);
-             if (file.open(QIODevice::WriteOnly)) {
-                 file.write(data);
-             } else {
-
-             }
-         }
-        delete exporter;
     }
+    return true;
 }
 
 void FontBuilder::on_pushButtonWriteFont_clicked()
 {
-    doExport(false);
-    if (m_output_config->generateX2()) {
-        m_font_renderer->render(2.0f);
-        doExport(true);
-        m_font_renderer->render(1.0f);
+    if (m_export_job || m_export_queued) return;
+    /// export what the settings say, not what the preview showed last
+    if (!m_scheduler->idle()) {
+        m_export_queued = true;
+        ui->pushButtonWriteFont->setEnabled(false);
+        statusBar()->showMessage(tr("Export waits for the preview to finish"));
+        return;
     }
+    startExport();
+}
+
+void FontBuilder::startExport()
+{
+    setLayoutImage(m_layout_data->image());
+    delete m_image_writer;
+    m_image_writer = 0;
+
+    ExportJob* job = new ExportJob(this);
+    job->setConfig(m_font_config,m_layout_config,m_output_config);
+    job->setData(m_layout_data,m_scheduler->data());
+    job->setLayouter(m_layout_config->layouter());
+    foreach (float scale, m_output_config->scaleList()) {
+        if (!addExportPass(job,scale)) {
+            delete job;
+            ui->pushButtonWriteFont->setEnabled(true);
+            return;
+        }
+    }
+
+    m_export_progress = new QProgressDialog(tr("Writing font.."),tr("Cancel"),0,0,this);
+    m_export_progress->setWindowModality(Qt::NonModal);
+    m_export_progress->setMinimumDuration(500);
+    connect(m_export_progress,SIGNAL(canceled()),job,SLOT(cancel()));
+    connect(job,SIGNAL(progress(int,int)),this,SLOT(onExportProgress(int,int)));
+    connect(job,SIGNAL(finished(bool)),this,SLOT(onExportFinished(bool)));
+    ui->pushButtonWriteFont->setEnabled(false);
+    m_export_job = job;
+    job->start();
+}
+
+void FontBuilder::onExportProgress(int value,int maximum) {
+    if (!m_export_progress) return;
+    m_export_progress->setMaximum(maximum);
+    m_export_progress->setValue(value);
+}
+
+void FontBuilder::onExportFinished(bool ok) {
+    ExportJob* job = m_export_job;
+    m_export_job = 0;
+    if (m_export_progress) {
+        m_export_progress->deleteLater();
+        m_export_progress = 0;
+    }
+    ui->pushButtonWriteFont->setEnabled(true);
+    if (!ok && !job->isCancelled() && !job->errorString().isEmpty()) {
+        QMessageBox msgBox;
+        msgBox.setText(job->errorString());
+        msgBox.exec();
+    }
+    m_image_writer = job->takeImageWriter();
+    if (m_image_writer) {
+        m_image_writer->setParent(this);
+        m_image_writer->watch(job->imageFile());
+        connect(m_image_writer,SIGNAL(imageChanged(QString)),this,SLOT(onExternalImageChanged(QString)));
+    }
+    job->deleteLater();
+}
+
+void FontBuilder::onRebuildProgress(int value,int maximum) {
+    /// a busy bar while the layouter packs the rasterized glyphs
+    m_rebuild_progress->setFormat(maximum ? tr("%v of %m glyphs") : QString());
+    m_rebuild_progress->setMaximum(maximum);
+    m_rebuild_progress->setValue(value);
+    m_rebuild_progress->show();
 }
 
 void FontBuilder::onExternalImageChanged(const QString& fn) {
@@ -370,7 +386,7 @@ void FontBuilder::onExternalImageChanged(const QString& fn) {
             m_font_renderer->SetImage(c.symbol,img);
         }*/
         setLayoutImage(*image);
-        m_layout_data->setImage(*image);
+        m_layout_data->setImage(*image,LayoutData::ImageExternal);
         qDebug() << "set layout image from exernal";
         ui->fontTestFrame->refresh();
         delete image;
@@ -392,12 +408,108 @@ void FontBuilder::on_action_Open_triggered()
 
     QString file = QFileDialog::getOpenFileName(this,tr("Select file"),
                                                 QString(),
-                                                tr("Font file(*.xml)"));
+                                                tr("Font file(*.xml *.fnt)"));
     if (!file.isEmpty()) {
-        if (m_font_loader->Load(file)) {
-
+        if (m_font_loader->Load(file,m_font_config,m_layout_config)) {
+            // locked glyphs are kept, only added characters are rasterized
+            m_scheduler->setLocked(m_font_loader->data());
+            m_font_config->setCharacters(m_font_loader->characters());
+            ui->frameCharacters->setConfig(m_font_config);
+        } else {
+            QMessageBox::critical(this,tr("Error"),m_font_loader->errorString());
         }
     }
 
 
 }
+
+void FontBuilder::on_action_OpenProject_triggered()
+{
+    QString file = QFileDialog::getOpenFileName(this,tr("Open project"),
+                                                m_project_file,
+                                                tr("FontBuilder project(*.fbp)"));
+    if (!file.isEmpty())
+        loadProject(file);
+}
+
+void FontBuilder::on_action_SaveProject_triggered()
+{
+    QString file = QFileDialog::getSaveFileName(this,tr("Save project"),
+                                                m_project_file,
+                                                tr("FontBuilder project(*.fbp)"));
+    if (file.isEmpty())
+        return;
+    /// locked glyphs are saved as the settings render them
+    if (!m_scheduler->idle()) {
+        m_save_queued = file;
+        statusBar()->showMessage(tr("Saving waits for the preview to finish"));
+        return;
+    }
+    saveProject(file);
+}
+
+void FontBuilder::saveProject(const QString& file)
+{
+    ProjectFile project;
+    if (project.Save(file,m_font_config,m_layout_config,m_output_config,m_scheduler->data()))
+        m_project_file = file;
+    else
+        QMessageBox::critical(this,tr("Error"),project.errorString());
+}
+
+void FontBuilder::onRebuildFinished()
+{
+    if (m_export_queued) {
+        m_export_queued = false;
+        statusBar()->clearMessage();
+        startExport();
+    }
+    if (!m_save_queued.isEmpty()) {
+        const QString file = m_save_queued;
+        m_save_queued.clear();
+        statusBar()->clearMessage();
+        saveProject(file);
+    }
+}
+
+void FontBuilder::on_action_Performance_triggered()
+{
+    if (!m_perf_dialog)
+        m_perf_dialog = new PerfDialog(this);
+    m_perf_dialog->show();
+    m_perf_dialog->raise();
+}
+
+bool FontBuilder::loadProject(const QString& filename) {
+    ProjectFile project;
+    if (!project.Load(filename)) {
+        QMessageBox::critical(this,tr("Error"),project.errorString());
+        return false;
+    }
+    m_project_file = filename;
+
+    /// applied like the settings in the constructor, changes coalesce into one pass
+    bool font_config_block = m_font_config->blockSignals(true);
+    project.apply("fontconfig",m_font_config);
+    m_font_config->normalize();
+    bool layout_config_block = m_layout_config->blockSignals(true);
+    project.apply("layoutconfig",m_layout_config);
+    m_layout_config->blockSignals(layout_config_block);
+    m_scheduler->setLocked(project.locked());
+
+    for (int i=0;i<ui->comboBoxLayouter->count();i++)
+        if (ui->comboBoxLayouter->itemText(i)==m_layout_config->layouter())
+            ui->comboBoxLayouter->setCurrentIndex(i);
+    ui->frameFontSelect->setConfig(m_font_config);
+    ui->frameFontOptions->setConfig(m_font_config);
+    ui->frameCharacters->setConfig(m_font_config);
+    ui->frameLayoutConfig->setConfig(m_layout_config);
+    m_font_config->blockSignals(font_config_block);
+    m_font_config->emmitChange();
+
+    /// after the font, which names the outputs after itself
+    project.apply("outputconfig",m_output_config);
+    ui->frameOutput->setConfig(m_output_config);
+    ui->fontTestFrame->refresh();
+    return true;
+}
@@ -38,11 +38,9 @@ namespace Ui {
     class FontBuilder;
 }
 
-class FontRenderer;
 class FontConfig;
 class LayoutConfig;
 class LayoutData;
-class AbstractLayouter;
 class LayouterFactory;
 class OutputConfig;
 class ExporterFactory;
@@ -50,6 +48,11 @@ class AbstractExporter;
 class ImageWriterFactory;
 class AbstractImageWriter;
 class FontLoader;
+class ExportJob;
+class QProgressDialog;
+class QProgressBar;
+class RebuildScheduler;
+class PerfDialog;
 
 
 class FontBuilder : public QMainWindow {
@@ -58,6 +61,9 @@ public:
     FontBuilder(QWidget *parent = 0);
     ~FontBuilder();
 
+    /// replaces configs and locked glyphs with the ones of a project file
+    bool loadProject(const QString& filename);
+
 protected:
     void changeEvent(QEvent *e);
     void closeEvent(QCloseEvent *event);
@@ -67,19 +73,28 @@ protected:
 private:
 
     Ui::FontBuilder *ui;
-    FontRenderer*   m_font_renderer;
     FontConfig*     m_font_config;
     LayoutConfig*   m_layout_config;
     LayoutData*     m_layout_data;
-    AbstractLayouter* m_layouter;
     LayouterFactory*    m_layouter_factory;
     OutputConfig*   m_output_config;
     ExporterFactory* m_exporter_factory;
     ImageWriterFactory* m_image_writer_factory;
     AbstractImageWriter* m_image_writer;
     FontLoader*     m_font_loader;
+    ExportJob*      m_export_job;
+    QProgressDialog* m_export_progress;
+    QString         m_project_file;
+    RebuildScheduler* m_scheduler;
+    QProgressBar*   m_rebuild_progress;
+    PerfDialog*     m_perf_dialog;
+    /// export and project save wait for the preview to match the settings
+    bool            m_export_queued;
+    QString         m_save_queued;
 
-    void doExport(bool x2);
+    bool addExportPass(ExportJob* job,float scale);
+    void startExport();
+    void saveProject(const QString& file);
     void setLayoutImage(const QImage& img);
 public slots:
 
@@ -96,6 +111,13 @@ private slots:
     void onSpacingChanged();
     void on_comboBox_currentIndexChanged(int index);
     void on_action_Open_triggered();
+    void on_action_OpenProject_triggered();
+    void on_action_SaveProject_triggered();
+    void on_action_Performance_triggered();
+    void onExportProgress(int value,int maximum);
+    void onExportFinished(bool ok);
+    void onRebuildProgress(int value,int maximum);
+    void onRebuildFinished();
 };
 
 #endif // FONTBUILDER_H
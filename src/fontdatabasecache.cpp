@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "fontdatabasecache.h"
+#include "atomicfile.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QDebug>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+#include <QStandardPaths>
+#else
+#include <QDesktopServices>
+#endif
+
+static const quint32 CacheMagic = 0x46424443;  // "FBDC"
+static const quint32 CacheVersion = 1;
+
+static QDataStream& operator<<(QDataStream& s,const FontDef& def) {
+    return s << def.style << def.file << qint32(def.face) << def.fixedsize << def.fixedsizes;
+}
+
+static QDataStream& operator>>(QDataStream& s,FontDef& def) {
+    qint32 face = 0;
+    s >> def.style >> def.file >> face >> def.fixedsize >> def.fixedsizes;
+    def.face = face;
+    return s;
+}
+
+static QDataStream& operator<<(QDataStream& s,const FontFileFaces& faces) {
+    s << faces.path << quint32(faces.mtime) << qint64(faces.size) << quint32(faces.faces.size());
+    typedef QPair<QString,FontDef> Face;
+    foreach (const Face& face, faces.faces)
+        s << face.first << face.second;
+    return s;
+}
+
+static QDataStream& operator>>(QDataStream& s,FontFileFaces& faces) {
+    quint32 mtime = 0;
+    qint64 size = 0;
+    quint32 count = 0;
+    s >> faces.path >> mtime >> size >> count;
+    faces.mtime = mtime;
+    faces.size = size;
+    faces.faces.clear();
+    for (quint32 i=0;i<count && s.status()==QDataStream::Ok;i++) {
+        QPair<QString,FontDef> face;
+        s >> face.first >> face.second;
+        faces.faces.push_back(face);
+    }
+    return s;
+}
+
+FontDatabaseCache::FontDatabaseCache() :
+    m_loaded(false),m_changed(false)
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+#else
+    QString dir = QDesktopServices::storageLocation(QDesktopServices::CacheLocation);
+#endif
+    if (!dir.isEmpty())
+        m_filename = QDir(dir).filePath("fontdatabase.cache");
+}
+
+void FontDatabaseCache::load() {
+    if (m_loaded)
+        return;
+    m_loaded = true;
+    QFile file(m_filename);
+    if (m_filename.isEmpty() || !file.open(QFile::ReadOnly))
+        return;
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_4_6);
+    quint32 magic = 0,version = 0,count = 0;
+    s >> magic >> version >> count;
+    if (magic!=CacheMagic || version!=CacheVersion)
+        return;
+    for (quint32 i=0;i<count && s.status()==QDataStream::Ok;i++) {
+        FontFileFaces faces;
+        s >> faces;
+        if (s.status()==QDataStream::Ok)
+            m_entries.insert(faces.path,faces);
+    }
+    qDebug() << "font cache:" << m_entries.size() << "files from" << m_filename;
+}
+
+bool FontDatabaseCache::save() {
+    if (!m_changed || m_filename.isEmpty())
+        return true;
+    QDir().mkpath(QFileInfo(m_filename).absolutePath());
+    AtomicFile file(m_filename);
+    if (!file.open(QFile::WriteOnly)) {
+        qDebug() << "failed write font cache" << m_filename;
+        return false;
+    }
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_4_6);
+    s << CacheMagic << CacheVersion << quint32(m_entries.size());
+    foreach (const FontFileFaces& faces, m_entries)
+        s << faces;
+    if (s.status()!=QDataStream::Ok || !file.commit())
+        return false;
+    m_changed = false;
+    return true;
+}
+
+bool FontDatabaseCache::find(const QString& path,uint mtime,qint64 size,FontFileFaces& faces) const {
+    QHash<QString,FontFileFaces>::ConstIterator it = m_entries.constFind(path);
+    if (it==m_entries.constEnd() || it->mtime!=mtime || it->size!=size)
+        return false;
+    faces = it.value();
+    return true;
+}
+
+const FontFileFaces& FontDatabaseCache::value(const QString& path) const {
+    static const FontFileFaces empty;
+    QHash<QString,FontFileFaces>::ConstIterator it = m_entries.constFind(path);
+    return it==m_entries.constEnd() ? empty : it.value();
+}
+
+void FontDatabaseCache::insert(const FontFileFaces& faces) {
+    m_entries.insert(faces.path,faces);
+    m_changed = true;
+}
+
+void FontDatabaseCache::prune(const QString& dir,const QStringList& paths) {
+    const QString absolute = QDir(dir).absolutePath();
+    const QSet<QString> keep = paths.toSet();
+    QHash<QString,FontFileFaces>::iterator it = m_entries.begin();
+    while (it!=m_entries.end()) {
+        if (!keep.contains(it.key()) && QFileInfo(it.key()).absolutePath()==absolute) {
+            it = m_entries.erase(it);
+            m_changed = true;
+        } else {
+            ++it;
+        }
+    }
+}
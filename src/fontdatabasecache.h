@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FONTDATABASECACHE_H
+#define FONTDATABASECACHE_H
+
+#include <QHash>
+#include <QString>
+#include "fontselectframe.h"
+
+/// Scanned faces of font files, kept between sessions. An entry is
+/// valid while the file keeps its modification time and size.
+class FontDatabaseCache
+{
+public:
+    FontDatabaseCache();
+
+    /// reads the cache file once, a missing or outdated file is empty
+    void load();
+    /// writes the cache file if entries changed
+    bool save();
+
+    /// faces of the file if it did not change since it was scanned
+    bool find(const QString& path,uint mtime,qint64 size,FontFileFaces& faces) const;
+    const FontFileFaces& value(const QString& path) const;
+    void insert(const FontFileFaces& faces);
+    /// drops entries of files in the directory that are not listed
+    void prune(const QString& dir,const QStringList& paths);
+private:
+    QString m_filename;
+    QHash<QString,FontFileFaces> m_entries;
+    bool m_loaded;
+    bool m_changed;
+};
+
+#endif // FONTDATABASECACHE_H
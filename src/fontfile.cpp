@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "fontfile.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWeakPointer>
+#include <QDebug>
+
+namespace {
+    QMutex registry_mutex;
+    QHash<QString,QWeakPointer<FontFile> > registry;
+}
+
+FontFile::FontFile(const QString& path) :
+    m_path(path),m_file(path),m_map(0),m_size(0),m_mtime(0)
+{
+}
+
+FontFile::~FontFile() {
+    if (m_map)
+        m_file.unmap(m_map);
+}
+
+bool FontFile::load() {
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+    m_size = m_file.size();
+    m_mtime = QFileInfo(m_file).lastModified().toTime_t();
+    m_map = m_file.map(0,m_size);
+    if (!m_map) {
+        qDebug() << "map failed, reading" << m_path;
+        m_bytes = m_file.readAll();
+        m_size = m_bytes.size();
+        m_file.close();
+    }
+    return true;
+}
+
+QSharedPointer<FontFile> FontFile::open(const QString& path) {
+    QFileInfo info(path);
+    const QString key = info.absoluteFilePath();
+    QMutexLocker lock(&registry_mutex);
+    QSharedPointer<FontFile> file = registry.value(key).toStrongRef();
+    // a file replaced on disk is opened again, old users keep the old one
+    if (file && file->m_mtime==info.lastModified().toTime_t() && file->m_size==info.size())
+        return file;
+    file = QSharedPointer<FontFile>(new FontFile(key));
+    if (!file->load())
+        return QSharedPointer<FontFile>();
+    registry.insert(key,file.toWeakRef());
+    // forget files nobody uses any more
+    QHash<QString,QWeakPointer<FontFile> >::iterator it = registry.begin();
+    while (it!=registry.end()) {
+        if (it->isNull())
+            it = registry.erase(it);
+        else
+            ++it;
+    }
+    return file;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef FONTFILE_H
+#define FONTFILE_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QSharedPointer>
+
+/// Contents of a font file, shared by every renderer that opens the same
+/// file. The file is memory mapped when the platform allows it and is
+/// released with the last reference. Safe to open from any thread.
+class FontFile
+{
+public:
+    ~FontFile();
+
+    /// shared contents of the file, null if it can not be read
+    static QSharedPointer<FontFile> open(const QString& path);
+
+    const uchar* data() const { return m_map ? m_map : reinterpret_cast<const uchar*>(m_bytes.constData());}
+    qint64 size() const { return m_size;}
+    const QString& path() const { return m_path;}
+private:
+    explicit FontFile(const QString& path);
+    bool load();
+
+    QString m_path;
+    QFile m_file;
+    uchar* m_map;
+    QByteArray m_bytes;
+    qint64 m_size;
+    uint m_mtime;
+};
+
+#endif // FONTFILE_H
@@ -1,7 +1,12 @@
 #include "fontloader.h"
+#include "fontconfig.h"
+#include "layoutconfig.h"
+#include "readerfactory.h"
 
 #include <QFile>
-#include <QDomDocument>
+#include <QFileInfo>
+#include <QDir>
+#include <QImage>
 #include <QDebug>
 
 FontLoader::FontLoader(QObject *parent) :
@@ -10,25 +15,75 @@ FontLoader::FontLoader(QObject *parent) :
 }
 
 
-bool FontLoader::Load(QString filename) {
+bool FontLoader::Load(QString filename,const FontConfig* font,const LayoutConfig* layout) {
+    m_data.chars.clear();
+    m_error_string.clear();
 
-    QDomDocument doc;
     QFile f;
     f.setFileName(filename);
-    QString error;
-    if (!f.open(QFile::ReadOnly | QFile::Text)) {
-        qDebug() << "Error opening font fike " << filename;
+    if (!f.open(QFile::ReadOnly)) {
+        m_error_string = tr("Error opening font file %1").arg(filename);
+        qDebug() << m_error_string;
         return false;
     }
-    if (!doc.setContent(&f,&error)) {
-        qDebug() << "Error loading font " << filename << " " << error;
+    QByteArray bytes = f.readAll();
+
+    QString format = bytes.trimmed().startsWith('<') ? "GHL" : "BMFont";
+    ReaderFactory factory;
+    AbstractReader* reader = factory.build(format,this);
+    if (!reader->Read(bytes)) {
+        m_error_string = tr("Error loading font %1: %2").arg(filename,reader->errorString());
+        qDebug() << m_error_string;
+        delete reader;
         return false;
     }
 
-    QDomElement root = doc.firstChildElement("font");
-    if (root.isNull()) return false;
+    QString texture = QFileInfo(filename).dir().filePath(reader->texFilename());
+    QImage atlas;
+    if (!atlas.load(texture)) {
+        m_error_string = tr("Error loading texture %1").arg(texture);
+        qDebug() << m_error_string;
+        delete reader;
+        return false;
+    }
+    atlas = atlas.convertToFormat(QImage::Format_ARGB32);
 
-    QDomElement chars = doc.firstChildElement("chars");
+    // undo the offsets and spacing AbstractExporter::setData applies
+    const int left = layout->offsetLeft();
+    const int top = layout->offsetTop();
+    const int right = layout->offsetRight();
+    const int bottom = layout->offsetBottom();
+    const AbstractReader::KerningPair* kernings = reader->kernings().constData();
+    foreach (const AbstractReader::Symbol& s, reader->symbols()) {
+        RenderedChar rc(s.id,s.offsetX+left,s.offsetY-top,s.advance-font->charSpacing(),
+                        atlas.copy(s.placeX+left,s.placeY+top,
+                                   s.placeW-left-right,s.placeH-top-bottom));
+        rc.locked = true;
+        for (int i=0;i<s.kerningCount;i++) {
+            const AbstractReader::KerningPair& k = kernings[s.kerningBegin+i];
+            rc.kerning[k.second] = k.amount;
+            rc.kerning64[k.second] = k.amount64;
+        }
+        m_data.chars[s.id] = rc;
+    }
+
+    // descender is not stored, keep the line height consistent
+    m_data.metrics.height = reader->lineHeight()-font->lineSpacing();
+    m_data.metrics.ascender = reader->ascender();
+    m_data.metrics.descender = m_data.metrics.ascender-m_data.metrics.height;
+    m_data.metrics.ascender64 = m_data.metrics.ascender*64;
+    m_data.metrics.descender64 = m_data.metrics.descender*64;
+    m_data.metrics.height64 = m_data.metrics.height*64;
+
+    qDebug() << "loaded" << m_data.chars.size() << "chars from" << filename;
+    delete reader;
+    return true;
+}
 
-    return false;
+QString FontLoader::characters() const {
+    QVector<uint> codes;
+    codes.reserve(m_data.chars.size());
+    for (QMap<uint,RenderedChar>::ConstIterator it = m_data.chars.begin();it!=m_data.chars.end();++it)
+        codes.push_back(it.key());
+    return QString::fromUcs4(codes.constData(),codes.size());
 }
@@ -2,14 +2,29 @@
 #define FONTLOADER_H
 
 #include <QObject>
+#include "rendererdata.h"
 
+class FontConfig;
+class LayoutConfig;
+
+/// Reads a previously exported font (GHL xml or BMFont text) and its
+/// atlas back into renderer data, so the glyphs can be locked instead
+/// of rasterized again.
 class FontLoader : public QObject
 {
     Q_OBJECT
 public:
     explicit FontLoader(QObject *parent = 0);
 
-    bool Load(QString filename);
+    /// configs give the offsets and spacing the font was exported with
+    bool Load(QString filename,const FontConfig* font,const LayoutConfig* layout);
+    const RendererData& data() const { return m_data;}
+    /// loaded symbols in code order
+    QString characters() const;
+    const QString& errorString() const { return m_error_string;}
+private:
+    RendererData m_data;
+    QString m_error_string;
 signals:
 
 public slots:
@@ -30,12 +30,13 @@
 
 #include "fontrenderer.h"
 #include "fontconfig.h"
+#include "fontfile.h"
+#include "perf.h"
 
 #include FT_OUTLINE_H
 #include FT_TRUETYPE_TABLES_H
 
 #include <QDir>
-#include <QFile>
 #include <QDebug>
 #include <QRgb>
 #include <QColor>
@@ -48,6 +49,7 @@ FontRenderer::FontRenderer(QObject *parent,const FontConfig* config) :
     m_ft_library = 0;
     m_ft_face = 0;
     m_scale = 1.0f;
+    m_cancel = 0;
     connect(config,SIGNAL(fileChanged()),this,SLOT(on_fontFileChanged()));
     connect(config,SIGNAL(faceIndexChanged()),this,SLOT(on_fontFaceIndexChanged()));
     connect(config,SIGNAL(sizeChanged()),this,SLOT(on_fontSizeChanged()));
@@ -69,6 +71,7 @@ FontRenderer::~FontRenderer() {
 }
 
 void FontRenderer::rasterize() {
+    PerfTimer timer("rasterize");
     clear_bitmaps();
     if (!m_ft_face) {
         return;
@@ -94,14 +97,20 @@ void FontRenderer::rasterize() {
 
     /// fill metrics
     if (FT_IS_SCALABLE(m_ft_face)) {
-        m_rendered.metrics.ascender = m_ft_face->size->metrics.ascender / 64;
-        m_rendered.metrics.descender = m_ft_face->size->metrics.descender/ 64;
-        m_rendered.metrics.height = m_ft_face->size->metrics.height/ 64;
+        m_rendered.metrics.ascender64 = m_ft_face->size->metrics.ascender;
+        m_rendered.metrics.descender64 = m_ft_face->size->metrics.descender;
+        m_rendered.metrics.height64 = m_ft_face->size->metrics.height;
+        m_rendered.metrics.ascender = m_rendered.metrics.ascender64 / 64;
+        m_rendered.metrics.descender = m_rendered.metrics.descender64 / 64;
+        m_rendered.metrics.height = m_rendered.metrics.height64 / 64;
 
     } else {
         m_rendered.metrics.ascender = m_ft_face->ascender;
         m_rendered.metrics.descender = m_ft_face->descender;
         m_rendered.metrics.height = m_ft_face->height;
+        m_rendered.metrics.ascender64 = m_rendered.metrics.ascender * 64;
+        m_rendered.metrics.descender64 = m_rendered.metrics.descender * 64;
+        m_rendered.metrics.height64 = m_rendered.metrics.height * 64;
     }
 
 
@@ -111,9 +120,15 @@ void FontRenderer::rasterize() {
     ucs4chars.push_back(0);
     int error = 0;
 	for (int i=0;i+1<ucs4chars.size();i++) {
+        if (m_cancel && m_cancel->fetchAndAddOrdered(0))
+            break;
+        rasterized(i,ucs4chars.size()-1);
         int glyph_index = FT_Get_Char_Index( m_ft_face, ucs4chars[i] );
         if (glyph_index==0 && !m_config->renderMissing())
             continue;
+        QMap<uint,RenderedChar>::ConstIterator locked = m_rendered.chars.constFind(ucs4chars[i]);
+        if (locked!=m_rendered.chars.constEnd() && locked->locked)
+            continue;
 
         FT_Int32 flags = FT_LOAD_DEFAULT;
         if (!m_config->antialiased()) {
@@ -150,10 +165,12 @@ void FontRenderer::rasterize() {
         if ( error )
            continue;
         if (append_bitmap(ucs4chars[i])) {
+            Perf::count("glyphs rendered");
             if (use_kerning)
                 append_kerning(ucs4chars[i],&ucs4chars.front(),ucs4chars.size()-1);
         }
     }
+    rasterized(ucs4chars.size()-1,ucs4chars.size()-1);
     imagesChanged(m_chars);
     imagesChanged();
 }
@@ -236,38 +253,48 @@ bool FontRenderer::append_bitmap(uint symbol) {
         }
     }
 
-    m_rendered.chars[symbol]=RenderedChar(symbol,slot->bitmap_left,slot->bitmap_top,slot->advance.x/64,img);
+    RenderedChar& rc = m_rendered.chars[symbol];
+    rc = RenderedChar(symbol,slot->bitmap_left,slot->bitmap_top,slot->advance.x/64,img);
+    rc.advance64 = slot->advance.x;
     m_chars.push_back(LayoutChar(symbol,slot->bitmap_left,-slot->bitmap_top,w,h));
 
     return true;
 }
 
 void FontRenderer::append_kerning(uint symbol,const uint* other,int amount) {
-     FT_Vector  kerning;
+     PerfTimer timer("kerning");
+     int pairs = 0;
+     FT_Vector  unfitted;
+     FT_Vector  fitted;
      FT_UInt left =  FT_Get_Char_Index( m_ft_face, symbol );
     for (int i=0;i<amount;i++) {
         if (other[i]!=symbol) {
             FT_UInt right =  FT_Get_Char_Index( m_ft_face, other[i] );
-            int error = FT_Get_Kerning( m_ft_face,          /* handle to face object */
-                                      left,          /* left glyph index      */
-                                      right,         /* right glyph index     */
-                                      FT_KERNING_DEFAULT,  /* kerning mode          */
-                                      &kerning );    /* target vector         */
-            if (error) {
-
-            } else {
-                int advance = kerning.x / 64;
-                if (advance!=0)
-                    m_rendered.chars[symbol].kerning[other[i]]=advance;
+            // below ~25 ppem the fitted amount is not the unfitted one rounded,
+            // so pixel formats get what FreeType grid fits and 26.6 formats the raw value
+            if (FT_Get_Kerning( m_ft_face, left, right, FT_KERNING_UNFITTED, &unfitted ) ||
+                FT_Get_Kerning( m_ft_face, left, right, FT_KERNING_DEFAULT, &fitted ))
+                continue;
+            if (unfitted.x!=0 || fitted.x!=0) {
+                RenderedChar& rc = m_rendered.chars[symbol];
+                rc.kerning[other[i]]=fitted.x/64;
+                rc.kerning64[other[i]]=unfitted.x;
+                pairs++;
             }
         }
     }
+    Perf::count("kerning pairs",pairs);
 }
 
 void FontRenderer::on_fontFileChanged() {
-    QFile file(QDir(m_config->path()).filePath(m_config->filename()));
-    if (file.open(QFile::ReadOnly)) {
-        m_data = file.readAll();
+    QSharedPointer<FontFile> file = FontFile::open(QDir(m_config->path()).filePath(m_config->filename()));
+    if (file) {
+        // the face reads the old contents until it is released
+        if (m_ft_face) {
+            FT_Done_Face(m_ft_face);
+            m_ft_face = 0;
+        }
+        m_file = file;
         on_fontFaceIndexChanged();
     }
 }
@@ -278,10 +305,10 @@ void FontRenderer::on_fontFaceIndexChanged() {
         FT_Done_Face(m_ft_face);
         m_ft_face = 0;
     }
-    if (!m_ft_library) return;
+    if (!m_ft_library || !m_file) return;
     int error =  FT_New_Memory_Face(
             m_ft_library,
-            reinterpret_cast<const FT_Byte*>(m_data.constData()),m_data.size(),
+            reinterpret_cast<const FT_Byte*>(m_file->data()),FT_Long(m_file->size()),
             m_config->faceIndex(),&m_ft_face);
     if (error) {
         qDebug() << "FT_New_Memory_Face error " << error;
@@ -296,7 +323,7 @@ void FontRenderer::on_fontFaceIndexChanged() {
 }
 
 
-void FontRenderer::on_fontSizeChanged() {
+void FontRenderer::set_char_size() {
     if (!m_ft_face) return;
     bool fixedsize = (FT_FACE_FLAG_SCALABLE & m_ft_face->face_flags ) == 0;
     int size = m_config->size();
@@ -313,6 +340,11 @@ void FontRenderer::on_fontSizeChanged() {
             qDebug() << "FT_Set_Char_Size error " << error;
         }
     }
+}
+
+void FontRenderer::on_fontSizeChanged() {
+    if (!m_ft_face) return;
+    set_char_size();
     rasterize();
 }
 
@@ -330,6 +362,13 @@ void FontRenderer::render(float scale) {
     on_fontSizeChanged();
 }
 
+/// load face and set size without rasterizing, used by standalone renderers
+void FontRenderer::open(float scale) {
+    m_scale = scale;
+    on_fontFileChanged();
+    set_char_size();
+}
+
 
 
 void FontRenderer::placeImage(QPainter& p,uint symbol,int x,int y) {
@@ -350,3 +389,16 @@ void FontRenderer::SetImage(uint symb,const QImage& img) {
     m_rendered.chars[symb].locked = true;
 }
 
+void FontRenderer::LoadLocked(const RendererData& data) {
+    m_rendered = data;
+    m_chars.clear();
+    m_chars.reserve(m_rendered.chars.size());
+    QMap<uint,RenderedChar>::iterator it = m_rendered.chars.begin();
+    while (it!=m_rendered.chars.end()) {
+        it->locked = true;
+        m_chars.push_back(LayoutChar(it.key(),it->offsetX,-it->offsetY,it->img.width(),it->img.height()));
+        it++;
+    }
+    imagesChanged(m_chars);
+    imagesChanged();
+}
@@ -32,8 +32,9 @@
 #define FONTRENDERER_H
 
 #include <QObject>
-#include <QByteArray>
 #include <QPainter>
+#include <QSharedPointer>
+#include <QAtomicInt>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -42,6 +43,7 @@
 #include "layoutchar.h"
 
 class FontConfig;
+class FontFile;
 
 class FontRenderer : public QObject
 {
@@ -55,22 +57,31 @@ public:
     const RendererData& data() const { return m_rendered;}
     void LockAll();
     void SetImage(uint symb,const QImage& img);
+    /// replaces all glyphs with locked ones, e.g. from FontLoader
+    void LoadLocked(const RendererData& data);
     FT_Face face() const { return m_ft_face; }
     void render(float scale);
+    void open(float scale);
     float scale() const { return m_scale; }
+    /// rasterize() stops once the flag is set, used by background passes
+    void setCancel(QAtomicInt* cancel) { m_cancel = cancel; }
 private:
     const FontConfig* m_config;
     FT_Library m_ft_library;
     FT_Face m_ft_face;
-    QByteArray  m_data;
+    QSharedPointer<FontFile> m_file;
     void rasterize();
     RendererData m_rendered;
     QVector<LayoutChar> m_chars;
     void clear_bitmaps();
     bool append_bitmap(uint symbol);
     void append_kerning(uint symbol,const uint* other,int amount);
+    void set_char_size();
     float   m_scale;
+    QAtomicInt* m_cancel;
 signals:
+    /// before each glyph of rasterize() and once it is done
+    void rasterized(int value,int maximum);
     void imagesChanged();
     void imagesChanged(const QVector<LayoutChar>&);
 public slots:
@@ -32,12 +32,17 @@
 #include "ui_fontselectframe.h"
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QDesktopServices>
 #include <QFileDialog>
-#include <QProgressDialog>
-#include <QDesktopServices>
+#include <QThreadStorage>
+#include <QtConcurrentMap>
 
 #include "fontconfig.h"
+#include "fontdatabasecache.h"
+#include "fontfile.h"
 
 
 #include <ft2build.h>
@@ -51,23 +56,107 @@ static const char* get_error_descr(FT_Error err) {
     return "unknown";
 }
 
+namespace {
+    /// one FreeType library per scanning thread, released on thread exit
+    struct ScanLibrary {
+        FT_Library library;
+        ScanLibrary() : library(0) {
+            int error = FT_Init_FreeType(&library);
+            if (error) {
+                qDebug() << "FT_Init_FreeType error " << error;
+                library = 0;
+            }
+        }
+        ~ScanLibrary() {
+            if (library)
+                FT_Done_FreeType(library);
+        }
+    };
+    QThreadStorage<ScanLibrary*> scan_libraries;
+
+    /// opens the faces of the mapped file, FreeType reads only the tables it needs
+    FontFileFaces scanFontFile(const QString& path) {
+        FontFileFaces result;
+        QFileInfo info(path);
+        result.path = path;
+        result.mtime = info.lastModified().toTime_t();
+        result.size = info.size();
+        if (!scan_libraries.hasLocalData())
+            scan_libraries.setLocalData(new ScanLibrary());
+        FT_Library library = scan_libraries.localData()->library;
+        if (!library)
+            return result;
+        const QString file_name = info.fileName();
+        // FreeType opens paths with the ANSI code page on Windows,
+        // the mapping reads any path Qt can open
+        QSharedPointer<FontFile> file = FontFile::open(path);
+        if (!file) {
+            qDebug() << "failed read font " << file_name;
+            return result;
+        }
+        FT_Face face;
+        int error = FT_New_Memory_Face(library,file->data(),FT_Long(file->size()),-1,&face);
+        if (error) {
+            qDebug() << "failed read font " << file_name << " " << get_error_descr(error);
+            return result;
+        }
+        int faces_num = face->num_faces;
+        FT_Done_Face(face);
+        for (int face_n = 0;face_n<faces_num;face_n++) {
+            error = FT_New_Memory_Face(library,file->data(),FT_Long(file->size()),face_n,&face);
+            /// skip font if load error
+            if (error!=0) {
+                qDebug() << "failed read font " << file_name << " " << face_n << " " << get_error_descr(error);
+                continue;
+            }
+            QString family = face->family_name;
+            /// skip font if not have family
+            if (!family.isEmpty()) {
+                bool fixedsizes = (FT_FACE_FLAG_SCALABLE & face->face_flags ) == 0;
+                FontDef def(face->style_name,file_name,face_n,fixedsizes);
+                if (fixedsizes) {
+                    for (int i=0;i<face->num_fixed_sizes;i++) {
+                        def.fixedsizes.push_back(
+                                QPair<int,int>(
+                                        face->available_sizes[i].width,
+                                        face->available_sizes[i].height));
+                    }
+                    qDebug() << " fixed sizes " << def.fixedsizes;
+                }
+                result.faces.push_back(qMakePair(family,def));
+            }
+            FT_Done_Face(face);
+        }
+        return result;
+    }
+}
+
 
 FontSelectFrame::FontSelectFrame(QWidget *parent) :
     QFrame(parent),
     ui(new Ui::FontSelectFrame)
 {
     ui->setupUi(this);
+    ui->progressBarScan->hide();
 
 
 
 
     m_config = 0;
+    m_config_pending = false;
+    m_scan = 0;
+    m_cache = new FontDatabaseCache();
 
 }
 
 
 FontSelectFrame::~FontSelectFrame()
 {
+    if (m_scan) {
+        m_scan->cancel();
+        m_scan->waitForFinished();
+    }
+    delete m_cache;
     delete ui;
 
 
@@ -88,50 +177,70 @@ void FontSelectFrame::changeEvent(QEvent *e)
 
 void FontSelectFrame::setConfig(FontConfig* config) {
     m_config = 0;
+    m_config_pending = false;
     if (config) {
-        bool b = config->blockSignals(true);
-        if (!config->path().isEmpty())
+        if (!config->path().isEmpty()) {
+            bool b = config->blockSignals(true);
             setFontsDirectory(config->path());
-        if (!config->filename().isEmpty())
-            selectFile(config->filename(),config->faceIndex());
-        else if (!m_database.isEmpty()) {
-            const FontDef& def = m_database.constBegin()->front();
-            selectFile(def.file,def.face);
-            config->setFilename(def.file);
+            config->blockSignals(b);
+            // with files to scan the selection is applied when the scan finishes
+            if (!m_scan)
+                applyConfig(config);
+            else
+                m_config_pending = true;
+        } else {
+            applyConfig(config);
         }
-        if (config->size()==0)
-            config->setSize(ui->comboBoxSize->itemText(0).toInt());
-        if (config->size())
-            selectSize(config->size());
-
-        config->setFamily(ui->comboBoxFamily->itemText(ui->comboBoxFamily->currentIndex()));
-        config->setStyle(ui->comboBoxStyle->itemText(ui->comboBoxStyle->currentIndex()));
-
-        config->blockSignals(b);
         m_config = config;
     }
 
 }
 
+void FontSelectFrame::applyConfig(FontConfig* config) {
+    m_config = 0;
+    bool b = config->blockSignals(true);
+    const QString filename = config->filename();
+    if (!config->filename().isEmpty())
+        selectFile(config->filename(),config->faceIndex());
+    else if (!m_database.isEmpty()) {
+        const FontDef& def = m_database.constBegin()->front();
+        selectFile(def.file,def.face);
+        config->setFilename(def.file);
+    }
+    if (config->size()==0)
+        config->setSize(ui->comboBoxSize->itemText(0).toInt());
+    if (config->size())
+        selectSize(config->size());
+
+    config->setFamily(ui->comboBoxFamily->itemText(ui->comboBoxFamily->currentIndex()));
+    config->setStyle(ui->comboBoxStyle->itemText(ui->comboBoxStyle->currentIndex()));
+
+    config->blockSignals(b);
+    m_config = config;
+    // a font picked after a background scan has to reach the renderer
+    if (!b && config->filename()!=filename)
+        config->emmitChange();
+}
+
 void FontSelectFrame::setFontsDirectory(QString dir_name) {
 
     if (m_config) m_config->setPath(dir_name);
 
+    if (m_scan) {
+        // results of the previous directory are dropped
+        m_scan->disconnect(this);
+        m_scan->cancel();
+        m_scan->waitForFinished();
+        delete m_scan;
+        m_scan = 0;
+    }
     m_database.clear();
+    ui->comboBoxFamily->clear();
 
 
 
     ui->lineEditFontsDir->setText(dir_name);
 
-    FT_Library library = 0;
-
-    int error = FT_Init_FreeType(&library);
-    if (error) {
-        qDebug() << "FT_Open_Library error " << error;
-        return;
-    }
-
-
     QDir dir(dir_name);
     QStringList files = dir.entryList(
             QStringList()
@@ -143,81 +252,142 @@ void FontSelectFrame::setFontsDirectory(QString dir_name) {
             << "*.FON",
             QDir::Files | QDir::Readable
             );
-    QProgressDialog* progress = 0;
-    if (!files.isEmpty()) {
-        progress = new QProgressDialog(
-                tr("Scanning directory.."),
-                tr("Cancel"),
-                0,files.size(),this);
-        progress->setCancelButton(0);
-        progress->setWindowModality(Qt::WindowModal);
-        //progress->show();
+    // files unchanged since the last scan come from the cache
+    m_cache->load();
+    QStringList changed;
+    for (int i=0;i<files.size();i++) {
+        files[i] = dir.filePath(files[i]);
+        QFileInfo info(files[i]);
+        FontFileFaces cached;
+        if (m_cache->find(files[i],info.lastModified().toTime_t(),info.size(),cached))
+            addFaces(cached);
+        else
+            changed.push_back(files[i]);
+    }
+    m_scan_files = files;
+    m_scan_dir = dir_name;
+    qDebug() << "fonts:" << files.size()-changed.size() << "cached," << changed.size() << "to scan";
+
+    // cached families are listed at once, scanned ones as they arrive
+    fillFamilies();
+    if (changed.isEmpty()) {
+        ui->progressBarScan->hide();
+        m_cache->prune(m_scan_dir,m_scan_files);
+        m_cache->save();
+        return;
     }
-    int progress_val = 0;
-    foreach (QString file_name, files) {
-        //qDebug() << "found font file : " << file_name;
-        QFile file(dir.filePath(file_name));
-        if (file.open(QFile::ReadOnly)) {
-            QByteArray bytes = file.readAll();
-            const FT_Byte* data = reinterpret_cast<const FT_Byte* >(bytes.data());
-            FT_Face face;
-            int error =  FT_New_Memory_Face(library,
-                                            data,bytes.size(),-1,&face);
-            if (error==0) {
-                int faces_num = face->num_faces;
-                FT_Done_Face(face);
-                for (int face_n = 0;face_n<faces_num;face_n++) {
-                    error =  FT_New_Memory_Face(library,
-                                                data,bytes.size(),face_n,&face);
-                    /// skip font if load error
-                    if (error!=0) {
-                         qDebug() << "failed read font " << file_name << " " << face_n << " " << get_error_descr(error);
-                        continue;
-                    }
 
-                    QString family = face->family_name;
-                    //qDebug() << "face " << family << " "
-                    //        << face->style_name;
-                    /// skip font if not have family
-                    if (family.isEmpty()) continue;
-
-                    bool fixedsizes = (FT_FACE_FLAG_SCALABLE & face->face_flags ) == 0;
-                    m_database[face->family_name].push_back(
-                            FontDef(face->style_name,
-                                    file_name,
-                                    face_n,
-                                    fixedsizes));
-                    if (fixedsizes) {
-                        for (int i=0;i<face->num_fixed_sizes;i++) {
-                            m_database[family].back().fixedsizes.push_back(
-                                    QPair<int,int>(
-                                            face->available_sizes[i].width,
-                                            face->available_sizes[i].height));
-                        }
-                        qDebug() << " fixed sizes " << m_database[family].back().fixedsizes;
+    ui->progressBarScan->setRange(0,changed.size());
+    ui->progressBarScan->setValue(0);
+    ui->progressBarScan->show();
 
-                    }
+    m_scan = new QFutureWatcher<FontFileFaces>(this);
+    connect(m_scan,SIGNAL(resultReadyAt(int)),this,SLOT(onScanResultReady(int)));
+    connect(m_scan,SIGNAL(finished()),this,SLOT(onScanFinished()));
+    connect(m_scan,SIGNAL(progressValueChanged(int)),ui->progressBarScan,SLOT(setValue(int)));
+    m_scan->setFuture(QtConcurrent::mapped(changed,scanFontFile));
+}
 
-                    FT_Done_Face(face);
+void FontSelectFrame::onScanResultReady(int index) {
+    foreach (const QString& family, addFaces(m_scan->resultAt(index)))
+        insertFamily(family);
+}
 
-                }
-            } else {
-                qDebug() << "failed read font " << file_name << " " << get_error_descr(error);
-            }
+QStringList FontSelectFrame::addFaces(const FontFileFaces& result) {
+    QStringList added;
+    typedef QPair<QString,FontDef> Face;
+    foreach (const Face& face, result.faces) {
+        FontStyles& styles = m_database[face.first];
+        styles.push_back(face.second);
+        if (styles.size()==1)
+            added.push_back(face.first);
+    }
+    return added;
+}
 
-        }
+void FontSelectFrame::insertFamily(const QString& family) {
+    // families show up while the scan runs, without selecting them
+    bool b = ui->comboBoxFamily->blockSignals(true);
+    int current = ui->comboBoxFamily->currentIndex();
+    int pos = 0;
+    while (pos<ui->comboBoxFamily->count() && ui->comboBoxFamily->itemText(pos)<family)
+        pos++;
+    ui->comboBoxFamily->insertItem(pos,family);
+    ui->comboBoxFamily->setCurrentIndex(current<0 ? -1 : (pos<=current ? current+1 : current));
+    ui->comboBoxFamily->blockSignals(b);
+}
 
-        progress_val++;
-        progress->setValue(progress_val);
+void FontSelectFrame::onScanFinished() {
+    ui->progressBarScan->hide();
+
+    foreach (const FontFileFaces& result, m_scan->future().results())
+        m_cache->insert(result);
+    const bool complete = !m_scan->isCanceled();
+    m_scan->deleteLater();
+    m_scan = 0;
+    if (complete) {
+        m_cache->prune(m_scan_dir,m_scan_files);
+        m_cache->save();
     }
-    FT_Done_FreeType(library);
 
+    // results arrive out of order, list styles in directory order
+    const QString family = ui->comboBoxFamily->currentText();
+    FontDef current;
+    int item_no = ui->comboBoxStyle->itemData(ui->comboBoxStyle->currentIndex()).toInt();
+    if (ui->comboBoxStyle->currentIndex()>=0 && item_no>=0 && item_no<m_database[family].size())
+        current = m_database[family][item_no];
+    m_database.clear();
+    typedef QPair<QString,FontDef> Face;
+    foreach (const QString& path, m_scan_files)
+        foreach (const Face& face, m_cache->value(path).faces)
+            m_database[face.first].push_back(face.second);
+
+    FontConfig* config = m_config;
+    m_config = 0;
+    // the combo got every family while the scan ran
+    bool same = ui->comboBoxFamily->count()==m_database.size();
+    int i = 0;
+    for (FontFamilys::const_iterator it = m_database.constBegin();same && it!=m_database.constEnd();++it,++i)
+        same = ui->comboBoxFamily->itemText(i)==it.key();
+    if (!same)
+        fillFamilies();
+    if (!family.isEmpty() && ui->comboBoxFamily->currentText()==family) {
+        // only the style order moved, keep the selected style
+        bool b = ui->comboBoxStyle->blockSignals(true);
+        fillStyles(family);
+        const FontStyles& styles = m_database[family];
+        for (int s=0;s<styles.size();s++)
+            if (styles[s].file==current.file && styles[s].face==current.face) {
+                ui->comboBoxStyle->setCurrentIndex(s);
+                break;
+            }
+        ui->comboBoxStyle->blockSignals(b);
+    }
+    if (!config)
+        return;
+    // a selection the user made during the scan wins over the config one
+    if (m_config_pending) {
+        m_config_pending = false;
+        applyConfig(config);
+    } else {
+        m_config = config;
+        if (ui->comboBoxFamily->currentText()!=family)
+            on_comboBoxFamily_currentIndexChanged(ui->comboBoxFamily->currentText());
+    }
+}
+
+void FontSelectFrame::fillFamilies() {
     /// fill combo
+    QString current = ui->comboBoxFamily->currentText();
+    bool b = ui->comboBoxFamily->blockSignals(true);
     ui->comboBoxFamily->clear();
     foreach (QString str, m_database.keys()) {
         ui->comboBoxFamily->addItem(str);
     }
-    ui->comboBoxFamily->setCurrentIndex(0);
+    ui->comboBoxFamily->blockSignals(b);
+    int index = ui->comboBoxFamily->findText(current);
+    ui->comboBoxFamily->setCurrentIndex(-1);
+    ui->comboBoxFamily->setCurrentIndex(index<0 ? 0 : index);
 }
 
 void FontSelectFrame::on_pushButtonChangeDir_clicked()
@@ -276,8 +446,14 @@ void FontSelectFrame::selectSize(int size) {
 void FontSelectFrame::on_comboBoxFamily_currentIndexChanged(QString family)
 {
     if (family.isEmpty()) return;
-    if (m_config)
+    if (m_config) {
         m_config->setFamily(family);
+        m_config_pending = false;
+    }
+    fillStyles(family);
+}
+
+void FontSelectFrame::fillStyles(const QString& family) {
     ui->comboBoxStyle->clear();
     int item_no = 0;
     foreach (const FontDef& def ,m_database[family]) {
@@ -300,6 +476,7 @@ void FontSelectFrame::on_comboBoxStyle_currentIndexChanged(int index )
             QString(tr("File"))+" : " + m_database[family][item_no].file
             );
         if (m_config) {
+            m_config_pending = false;
             m_config->setFilename(m_database[family][item_no].file);
             m_config->setFaceIndex(m_database[family][item_no].face);
             m_config->setStyle(m_database[family][item_no].style);
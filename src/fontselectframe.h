@@ -37,6 +37,8 @@
 #include <QVector>
 #include <QByteArray>
 #include <QPair>
+#include <QStringList>
+#include <QFutureWatcher>
 
 struct FontDef {
     QString style;
@@ -49,7 +51,17 @@ struct FontDef {
         file(f),face(num),fixedsize(fixedsize) {}
 };
 
+/// faces found in one font file, with their family names
+struct FontFileFaces {
+    QString path;
+    uint mtime;
+    qint64 size;
+    QVector<QPair<QString,FontDef> > faces;
+    FontFileFaces() : mtime(0),size(0) {}
+};
+
 class FontConfig;
+class FontDatabaseCache;
 
 typedef QVector<FontDef> FontStyles;
 typedef QPair<QString,FontStyles> FontFamilsElement;
@@ -72,12 +84,26 @@ protected:
     void readFontSizes(const FontDef& def);
     void selectFile(const QString& file,int face);
     void selectSize(int size);
+    void applyConfig(FontConfig* config);
+    void fillFamilies();
+    void fillStyles(const QString& family);
+    /// adds the faces to m_database, returns the families it did not have
+    QStringList addFaces(const FontFileFaces& result);
+    void insertFamily(const QString& family);
 private:
     Ui::FontSelectFrame *ui;
     FontFamilys m_database;
     FontConfig* m_config;
+    /// config selection waits for the scan, until the user picks a font
+    bool m_config_pending;
+    QFutureWatcher<FontFileFaces>* m_scan;
+    QStringList m_scan_files;
+    QString m_scan_dir;
+    FontDatabaseCache* m_cache;
 signals:
 private slots:
+    void onScanResultReady(int index);
+    void onScanFinished();
     void on_pushButtonDefault_clicked();
     void on_comboBoxSize_currentIndexChanged(QString );
     void on_comboBoxSize_editTextChanged(QString );
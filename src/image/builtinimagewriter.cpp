@@ -43,9 +43,13 @@ BuiltinImageWriter::BuiltinImageWriter(QString format,QString ext,QObject *paren
 }
 
 
-bool BuiltinImageWriter::Export(QFile& file) {
-    QImage pixmap = buildImage();
-    pixmap.save(&file,m_format.toUtf8().data());
+bool BuiltinImageWriter::Export(QFile& file,const AtlasView& atlas) {
+    /// wraps the atlas memory, QImage does not copy a const buffer
+    const QImage pixmap(atlas.data,atlas.width,atlas.height,atlas.stride,atlas.format);
+    if (!pixmap.save(&file,m_format.toUtf8().data())) {
+        setErrorMessage(tr("Failed to encode image"));
+        return false;
+    }
     return true;
 }
 
@@ -40,7 +40,7 @@ Q_OBJECT
 public:
     BuiltinImageWriter(QString format,QString ext,QObject *parent = 0);
 
-    virtual bool Export(QFile& file);
+    virtual bool Export(QFile& file,const AtlasView& atlas);
     virtual QImage* reload(QFile& file);
 private:
     QString m_format;
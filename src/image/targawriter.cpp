@@ -38,6 +38,13 @@
 
 #include <QDebug>
 
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TGA_USE_SSE2
+#endif
+
 TargaImageWriter::TargaImageWriter(QString ext,QObject *parent) :
     AbstractImageWriter(parent)
 {
@@ -93,8 +100,15 @@ struct TGA_HEADER
 #undef PACK_STRUCT
 
 
-bool TargaImageWriter::Export(QFile& file) {
-    QImage pixmap = buildImage();
+bool TargaImageWriter::Export(QFile& file,const AtlasView& atlas) {
+    /// rows are written straight from the atlas, only foreign formats are converted
+    QImage converted;
+    AtlasView view = atlas;
+    if (view.format!=QImage::Format_ARGB32) {
+        converted = QImage(atlas.data,atlas.width,atlas.height,atlas.stride,atlas.format)
+                .convertToFormat(QImage::Format_ARGB32);
+        view = AtlasView(converted);
+    }
 
     TGA_HEADER header;
     header.idlength = 0;
@@ -105,125 +119,182 @@ bool TargaImageWriter::Export(QFile& file) {
     header.colourmapdepth = 0;
     header.x_origin = 0;
     header.y_origin = 0;
-    header.width = pixmap.width();
-    header.height = pixmap.height();
+    header.width = view.width;
+    header.height = view.height;
     header.bitsperpixel = 32;
     header.imagedescriptor = (1 << 5) | (8);
 
-    file.write((const char*)&header,18);
-    for (int y=0;y<pixmap.height();y++) {
-        /// @todo need endian control
-        file.write((const char*)pixmap.scanLine(y),pixmap.width()*4);
+    /// @todo need endian control
+    const qint64 line_len = qint64(view.width)*4;
+    const qint64 size = 18 + line_len*view.height;
+    /// size is known up front, so map the output and copy rows without buffering
+    uchar* out = 0;
+    if (file.pos()==0 && file.resize(size))
+        out = file.map(0,size);
+    if (out) {
+        ::memcpy(out,&header,18);
+        for (int y=0;y<view.height;y++)
+            ::memcpy(out+18+line_len*y,view.data+qint64(y)*view.stride,line_len);
+        file.unmap(out);
+        file.seek(size);
+        return true;
     }
 
-
+    file.write((const char*)&header,18);
+    if (view.stride==line_len) {
+        if (file.write((const char*)view.data,line_len*view.height)!=line_len*view.height) {
+            setErrorMessage(file.errorString());
+            return false;
+        }
+    } else {
+        for (int y=0;y<view.height;y++) {
+            if (file.write((const char*)(view.data+qint64(y)*view.stride),line_len)!=line_len) {
+                setErrorMessage(file.errorString());
+                return false;
+            }
+        }
+    }
 
     return true;
 }
 
-template <int bpp>
-        inline uchar* copy_element(const uchar* src,uchar* dst);
-
-template <>
-        inline uchar* copy_element<3>(const uchar* src,uchar* dst) {
-    *dst++=*src++;
-    *dst++=*src++;
-    *dst++=*src++;
-    return dst;
-}
-
-template <>
-        inline uchar* copy_element<4>(const uchar* src,uchar* dst) {
-    *dst++=*src++;
-    *dst++=*src++;
-    *dst++=*src++;
-    *dst++=*src++;
-    return dst;
+static inline uint read_u16(const uchar* p) {
+    return uint(p[0]) | (uint(p[1]) << 8);
 }
 
+/// decode RLE packets into dst, never reading past end or writing more than count pixels
 template <int bpp>
-        void encode_rle(uchar* data,QFile& file,int size) {
-    uchar c;
-    while (size>0) {
-        if (file.read(reinterpret_cast<char*>(&c),1)!=1) return;
+static bool decode_rle(const uchar* src,const uchar* end,uchar* dst,int count) {
+    while (count>0) {
+        if (src>=end) return false;
+        int c = *src++;
         if (c < 128) {
-            c++;
-            file.read(reinterpret_cast<char*>(data), bpp * c);
-            data+=bpp * c;
-            size-= c;
+            int n = c + 1;
+            if (n>count || (end-src) < n*bpp) return false;
+            ::memcpy(dst,src,n*bpp);
+            src+=n*bpp;
+            dst+=n*bpp;
+            count-=n;
         } else {
-            c-=127;
-            file.read(reinterpret_cast<char*>(data), bpp);
-            uchar* out = data + bpp;
-            for(uint counter = 1; counter < c; counter++)
-            {
-                out = copy_element<bpp>(data,out);
+            int n = c - 127;
+            if (n>count || (end-src) < bpp) return false;
+            for (int i=0;i<n;i++) {
+                for (int b=0;b<bpp;b++)
+                    *dst++ = src[b];
             }
-            data = out;
-            size-= c;
+            src+=bpp;
+            count-=n;
+        }
+    }
+    return true;
+}
+
+/// expand BGR to BGRA walking forward; safe in place when src lies
+/// at dst + count inside the same 32bpp buffer
+static void expand_24_to_32(const uchar* src,uchar* dst,int count) {
+    for (int i=0;i<count;i++) {
+        uchar b = src[0];
+        uchar g = src[1];
+        uchar r = src[2];
+        dst[0] = b;
+        dst[1] = g;
+        dst[2] = r;
+        dst[3] = 255;
+        src+=3;
+        dst+=4;
+    }
+}
+
+static void swap_rows(uchar* a,uchar* b,int len) {
+    int i = 0;
+#ifdef TGA_USE_SSE2
+    for (;i+16<=len;i+=16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a+i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a+i),vb);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b+i),va);
+    }
+#endif
+    for (;i<len;i++) {
+        uchar t = a[i];
+        a[i] = b[i];
+        b[i] = t;
+    }
+}
+
+static bool decode(const uchar* src,const uchar* end,QImage& img,int bpp,bool rle,bool top_down) {
+    const int width = img.width();
+    const int height = img.height();
+    const int count = width*height;
+    const int line_len = width*4;
+    uchar* data = img.bits();
+    if (!rle) {
+        /// raw rows go straight to their final place, no flip pass needed
+        if ((end-src) < qint64(count)*(bpp/8)) return false;
+        for (int y=0;y<height;y++) {
+            uchar* dst = data + line_len*(top_down ? y : height-1-y);
+            if (bpp==32)
+                ::memcpy(dst,src,line_len);
+            else
+                expand_24_to_32(src,dst,width);
+            src+=width*(bpp/8);
         }
+        return true;
+    }
+    if (bpp==32) {
+        if (!decode_rle<4>(src,end,data,count)) return false;
+    } else {
+        /// decode into the tail of the image and expand in place
+        uchar* tail = data + count;
+        if (!decode_rle<3>(src,end,tail,count)) return false;
+        expand_24_to_32(tail,data,count);
+    }
+    if (!top_down) {
+        for (int i=0;i<height/2;i++)
+            swap_rows(data+line_len*i,data+line_len*(height-1-i),line_len);
     }
+    return true;
 }
 
 QImage* TargaImageWriter::reload(QFile& file) {
-    TGA_HEADER header;
-    if (file.read(reinterpret_cast<char*>(&header),18)!=18)
-        return 0;
-    /// don`t support palette
-    if (header.colourmaptype)
-        return 0;
-    bool rle = header.datatypecode & 8;
-    /// support only True Color data
-    if ( (header.datatypecode&7) != 2)
+    const qint64 size = file.size();
+    if (size<18)
         return 0;
-    int bpp = header.bitsperpixel;
-    /// support only 24 and 32 bpp
-    if (bpp!=24 && bpp!=32)
-        return 0;
-    int width = header.width;
-    int height = header.height;
-    /// @todo endian !
-    QImage* img = 0;
-    img = new QImage(width,height,QImage::Format_ARGB32);
-    img->fill(0);
-    uchar* data = reinterpret_cast<uchar*>(img->bits());
-    if (bpp==32) {
-        if (!rle) {
-            qDebug() << "Load TGA 32bpp";
-            file.read(reinterpret_cast<char*>(data),width*height*4);
-        } else {
-            qDebug() << "Load TGA 32bpp, rle";
-            encode_rle<4>(data,file,width*height);
-        }
-    } else if (bpp==24) {
-        uchar* src = new uchar [ width * height * 3];
-        if (!rle) {
-            qDebug() << "Load TGA 24bpp";
-            file.read(reinterpret_cast<char*>(src),width*height*3);
-        } else {
-            qDebug() << "Load TGA 24bpp, rle";
-            encode_rle<3>(src,file,width*height);
-        }
-        const uchar* s = src;
-        uchar* d = data;
-        for (int i=0;i<width*height;i++) {
-            *d++ = *s++;
-            *d++ = *s++;
-            *d++ = *s++;
-            *d++ = 255;
-        }
-        delete [] src;
+    /// map the whole file when possible, otherwise read it with one call
+    QByteArray buffer;
+    uchar* mapped = file.map(0,size);
+    const uchar* src = mapped;
+    if (!src) {
+        buffer = file.readAll();
+        if (buffer.size()!=size)
+            return 0;
+        src = reinterpret_cast<const uchar*>(buffer.constData());
     }
-    /// swap top-bottom
-    qDebug() << "header.imagedescriptor : " << int(header.imagedescriptor);
-    const int line_len = width*4;
-    if ((header.imagedescriptor & (1<<5))==0) {
-        uchar line[width * 4];
-        for (int i=0;i<height/2;i++) {
-            ::memcpy(line,data+line_len*i,line_len);
-            ::memcpy(data+line_len*i,data+line_len*(height-1-i),line_len);
-            ::memcpy(data+line_len*(height-1-i),line,line_len);
+    const uchar* end = src + size;
+
+    QImage* img = 0;
+    const int idlength = src[0];
+    const int colourmaptype = src[1];
+    const int datatypecode = src[2];
+    const int width = read_u16(src+12);
+    const int height = read_u16(src+14);
+    const int bpp = src[16];
+    const int imagedescriptor = src[17];
+    bool rle = datatypecode & 8;
+    /// don`t support palette, support only True Color 24 and 32 bpp data
+    if (!colourmaptype && (datatypecode&7)==2 && (bpp==24 || bpp==32) &&
+        width>0 && height>0 && size>=18+idlength) {
+        qDebug() << "Load TGA " << bpp << "bpp" << (rle ? ", rle" : "");
+        qDebug() << "header.imagedescriptor : " << imagedescriptor;
+        img = new QImage(width,height,QImage::Format_ARGB32);
+        if (img->isNull() ||
+            !decode(src+18+idlength,end,*img,bpp,rle,(imagedescriptor & (1<<5))!=0)) {
+            qDebug() << "Broken TGA data";
+            delete img;
+            img = 0;
         }
     }
+    if (mapped)
+        file.unmap(mapped);
     return img;
 }
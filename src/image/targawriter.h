@@ -39,7 +39,7 @@ Q_OBJECT
 public:
     TargaImageWriter(QString ext,QObject *parent = 0);
 
-    virtual bool Export(QFile& file);
+    virtual bool Export(QFile& file,const AtlasView& atlas);
     virtual QImage* reload(QFile& file);
 private:
 signals:
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "kerningclasses.h"
+
+#include <QHash>
+#include <QByteArray>
+
+KerningClasses::KerningClasses() :
+    m_pair_count(0),m_left_count(1),m_right_count(1)
+{
+    m_matrix.fill(0,1);
+    m_matrix64.fill(0,1);
+}
+
+static void appendInt(QByteArray& key,int value) {
+    key.append(reinterpret_cast<const char*>(&value),sizeof(value));
+}
+
+void KerningClasses::build(const QVector<AbstractExporter::KerningPair>& pairs) {
+    m_left.clear();
+    m_right.clear();
+    m_pair_count = pairs.size();
+
+    // left classes: first glyphs with the same (second, amount) row
+    QHash<QByteArray,int> rows;
+    QVector<int> row_begin;
+    QVector<int> row_end;
+    for (int i=0;i<pairs.size();) {
+        int end = i;
+        QByteArray key;
+        while (end<pairs.size() && pairs[end].first==pairs[i].first) {
+            appendInt(key,pairs[end].second);
+            appendInt(key,pairs[end].amount);
+            appendInt(key,pairs[end].amount64);
+            end++;
+        }
+        int cls = rows.value(key,0);
+        if (!cls) {
+            row_begin.push_back(i);
+            row_end.push_back(end);
+            cls = row_begin.size();
+            rows.insert(key,cls);
+        }
+        m_left.insert(pairs[i].first,cls);
+        i = end;
+    }
+    m_left_count = row_begin.size()+1;
+
+    // right classes: second glyphs with the same column over left classes
+    QMap<uint,QByteArray> columns;
+    for (int cls=1;cls<m_left_count;cls++) {
+        for (int i=row_begin[cls-1];i<row_end[cls-1];i++) {
+            QByteArray& key = columns[pairs[i].second];
+            appendInt(key,cls);
+            appendInt(key,pairs[i].amount);
+            appendInt(key,pairs[i].amount64);
+        }
+    }
+    QHash<QByteArray,int> cols;
+    for (QMap<uint,QByteArray>::ConstIterator it=columns.constBegin();it!=columns.constEnd();++it) {
+        int cls = cols.value(it.value(),0);
+        if (!cls) {
+            cls = cols.size()+1;
+            cols.insert(it.value(),cls);
+        }
+        m_right.insert(it.key(),cls);
+    }
+    m_right_count = cols.size()+1;
+
+    m_matrix.fill(0,m_left_count*m_right_count);
+    m_matrix64.fill(0,m_left_count*m_right_count);
+    for (int cls=1;cls<m_left_count;cls++) {
+        for (int i=row_begin[cls-1];i<row_end[cls-1];i++) {
+            const int cell = cls*m_right_count+m_right.value(pairs[i].second);
+            m_matrix[cell] = pairs[i].amount;
+            m_matrix64[cell] = pairs[i].amount64;
+        }
+    }
+}
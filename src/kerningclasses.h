@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef KERNINGCLASSES_H
+#define KERNINGCLASSES_H
+
+#include <QMap>
+#include <QVector>
+#include "abstractexporter.h"
+
+/// Exact class form of a kerning table. Glyphs with identical kerning rows
+/// share a left class, glyphs with identical columns share a right class,
+/// and amount(first,second) equals the pair amount for every glyph pair.
+/// Class 0 is the glyphs without kerning, its row and column are zero.
+/// Classes are built on both the pixel and 26.6 amounts, so both matrices are exact.
+class KerningClasses
+{
+public:
+    KerningClasses();
+
+    /// pairs must be sorted by (first, second)
+    void build(const QVector<AbstractExporter::KerningPair>& pairs);
+
+    int leftCount() const { return m_left_count;}
+    int rightCount() const { return m_right_count;}
+    int leftClass(uint code) const { return m_left.value(code,0);}
+    int rightClass(uint code) const { return m_right.value(code,0);}
+    const QMap<uint,int>& leftClasses() const { return m_left;}
+    const QMap<uint,int>& rightClasses() const { return m_right;}
+    int amount(int left,int right) const { return m_matrix[left*m_right_count+right];}
+    const QVector<int>& matrix() const { return m_matrix;}
+    int amount64(int left,int right) const { return m_matrix64[left*m_right_count+right];}
+    const QVector<int>& matrix64() const { return m_matrix64;}
+
+    int pairCount() const { return m_pair_count;}
+    /// matrix cells plus class assignments
+    int tableSize() const { return m_matrix.size()+m_left.size()+m_right.size();}
+private:
+    int m_pair_count;
+    int m_left_count;
+    int m_right_count;
+    QMap<uint,int> m_left;
+    QMap<uint,int> m_right;
+    QVector<int> m_matrix;
+    QVector<int> m_matrix64;
+};
+
+#endif // KERNINGCLASSES_H
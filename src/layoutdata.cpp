@@ -31,7 +31,7 @@
 #include "layoutdata.h"
 
 LayoutData::LayoutData(QObject *parent) :
-    QObject(parent)
+    QObject(parent), m_width(0), m_height(0), m_image_origin(ImageComposited)
 {
 }
 
@@ -55,13 +55,18 @@ public:
     void endPlacing();
 
     const QVector<LayoutChar>& placed() const { return m_placed;}
-    void setImage(const QImage& image) { m_image = image;}
+    /// where image() came from, exports reuse only what was composited
+    /// from the placed glyphs, an edited atlas may not match them
+    enum ImageOrigin { ImageComposited, ImageExternal };
+    void setImage(const QImage& image,ImageOrigin origin = ImageComposited) { m_image = image;m_image_origin = origin;}
     const QImage& image() const { return m_image;}
+    ImageOrigin imageOrigin() const { return m_image_origin;}
 private:
     int m_width;
     int m_height;
     QVector<LayoutChar> m_placed;
     QImage    m_image;
+    ImageOrigin m_image_origin;
 signals:
     void layoutChanged();
 public slots:
@@ -35,15 +35,39 @@
 #include <QtGui/QApplication>
 #endif
 #include <QCoreApplication>
+#include <QStringList>
+#include <cstring>
 #include "fontbuilder.h"
+#include "batchbuilder.h"
+
+static bool isBatch(int argc, char *argv[])
+{
+    for (int i=1;i<argc;i++)
+        if (::strcmp(argv[i],"--batch")==0)
+            return true;
+    return false;
+}
 
 int main(int argc, char *argv[])
 {
+    if (isBatch(argc,argv)) {
+        /// no widgets, safe without a display
+        QCoreApplication a(argc, argv);
+        QCoreApplication::setOrganizationName("AndryBlack");
+        QCoreApplication::setOrganizationDomain("andryblack.com");
+        QCoreApplication::setApplicationName("FontBuilder");
+        BatchBuilder builder;
+        return builder.run(a.arguments());
+    }
     QApplication a(argc, argv);
     QCoreApplication::setOrganizationName("AndryBlack");
     QCoreApplication::setOrganizationDomain("andryblack.com");
     QCoreApplication::setApplicationName("FontBuilder");
     FontBuilder w;
     w.show();
+    const QStringList arguments = a.arguments();
+    int project = arguments.indexOf("--project");
+    if (project>=0 && project+1<arguments.size())
+        w.loadProject(arguments[project+1]);
     return a.exec();
 }
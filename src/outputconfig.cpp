@@ -30,13 +30,17 @@
 
 #include "outputconfig.h"
 
+#include <QStringList>
+#include <QtAlgorithms>
+
 OutputConfig::OutputConfig(QObject *parent) :
     QObject(parent)
 {
     m_write_image = true;
     m_write_description = true;
-    m_image_format = "PNG";
-    m_generate_x2 = false;
+    m_kerning_classes = false;
+    m_image_formats << "PNG";
+    m_scales = "1";
 }
 
 void OutputConfig::setImageName(const QString& name) {
@@ -52,3 +56,35 @@ void OutputConfig::setDescriptionName(const QString& name) {
         descriptionNameChanged(name);
     }
 }
+
+QList<float> OutputConfig::scaleList() const {
+    QList<float> list;
+    foreach (const QString& str, m_scales.split(',',QString::SkipEmptyParts)) {
+        bool ok = false;
+        float scale = str.trimmed().toFloat(&ok);
+        if (ok && scale>0.0f && !list.contains(scale))
+            list.push_back(scale);
+    }
+    qSort(list);
+    if (list.isEmpty())
+        list.push_back(1.0f);
+    return list;
+}
+
+void OutputConfig::setScaleList(const QList<float>& scales) {
+    QStringList list;
+    foreach (float scale, scales)
+        list.push_back(QString::number(scale));
+    m_scales = list.join(",");
+}
+
+void OutputConfig::setGenerateX2(bool generate) {
+    QList<float> list = scaleList();
+    if (generate == list.contains(2.0f))
+        return;
+    if (generate)
+        list.push_back(2.0f);
+    else
+        list.removeAll(2.0f);
+    setScaleList(list);
+}
@@ -33,6 +33,8 @@
 
 #include <QObject>
 #include <QImage>
+#include <QList>
+#include <QStringList>
 
 class OutputConfig : public QObject
 {
@@ -48,18 +50,29 @@ public:
     void setImageName(const QString& name);
     Q_PROPERTY(QString imageName READ imageName WRITE setImageName)
 
-    const QString& imageFormat() const { return m_image_format;}
-    void setImageFormat(const QString& format) { m_image_format=format;}
+    /// kept for settings written by older versions, first of imageFormats
+    QString imageFormat() const { return m_image_formats.value(0);}
+    void setImageFormat(const QString& format) { m_image_formats = format.isEmpty() ? QStringList() : QStringList(format);}
     Q_PROPERTY(QString imageFormat READ imageFormat WRITE setImageFormat)
 
+    /// every format is written by one export, descriptions refer to the first
+    const QStringList& imageFormats() const { return m_image_formats;}
+    void setImageFormats(const QStringList& formats) { m_image_formats=formats;}
+    Q_PROPERTY(QStringList imageFormats READ imageFormats WRITE setImageFormats)
+
     const QString& descriptionName() const { return m_description_name;}
     void setDescriptionName(const QString& name);
     Q_PROPERTY(QString descriptionName READ descriptionName WRITE setDescriptionName)
 
-    const QString& descriptionFormat() const { return m_description_format;}
-    void setDescriptionFormat(const QString& format) { m_description_format=format;}
+    /// kept for settings written by older versions, first of descriptionFormats
+    QString descriptionFormat() const { return m_description_formats.value(0);}
+    void setDescriptionFormat(const QString& format) { m_description_formats = format.isEmpty() ? QStringList() : QStringList(format);}
     Q_PROPERTY(QString descriptionFormat READ descriptionFormat WRITE setDescriptionFormat)
 
+    const QStringList& descriptionFormats() const { return m_description_formats;}
+    void setDescriptionFormats(const QStringList& formats) { m_description_formats=formats;}
+    Q_PROPERTY(QStringList descriptionFormats READ descriptionFormats WRITE setDescriptionFormats)
+
     bool writeImage() const { return m_write_image;}
     void setWriteImage(bool write) { m_write_image = write;}
     Q_PROPERTY(bool writeImage READ writeImage WRITE setWriteImage )
@@ -68,18 +81,32 @@ public:
     void setWriteDescription(bool write) { m_write_description = write;}
     Q_PROPERTY(bool writeDescription READ writeDescription WRITE setWriteDescription )
 
-    bool generateX2() const { return m_generate_x2;}
-    void setGenerateX2(bool write) { m_generate_x2 = write;}
+    /// class matrix instead of kerning pairs in formats that support it
+    bool kerningClasses() const { return m_kerning_classes;}
+    void setKerningClasses(bool use) { m_kerning_classes = use;}
+    Q_PROPERTY(bool kerningClasses READ kerningClasses WRITE setKerningClasses )
+
+    /// comma separated list of output scales, "1,2" writes 1x and x2 fonts
+    const QString& scales() const { return m_scales;}
+    void setScales(const QString& scales) { m_scales = scales;}
+    Q_PROPERTY(QString scales READ scales WRITE setScales)
+    QList<float> scaleList() const;
+    void setScaleList(const QList<float>& scales);
+
+    /// kept for settings written by older versions, same as scale 2 in scales
+    bool generateX2() const { return scaleList().contains(2.0f);}
+    void setGenerateX2(bool generate);
     Q_PROPERTY(bool generateX2 READ generateX2 WRITE setGenerateX2 )
 private:
     QString m_path;
     bool    m_write_image;
     QString m_image_name;
-    QString m_image_format;
+    QStringList m_image_formats;
     bool    m_write_description;
     QString m_description_name;
-    QString m_description_format;
-    bool    m_generate_x2;
+    QStringList m_description_formats;
+    bool    m_kerning_classes;
+    QString m_scales;
 signals:
     void imageNameChanged(const QString&);
     void descriptionNameChanged(const QString&);
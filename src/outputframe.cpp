@@ -36,6 +36,9 @@
 #include <QFileDialog>
 #include <QImage>
 #include <QImageWriter>
+#include <QListWidget>
+
+static const float scales[] = { 0.5f,1.0f,2.0f,3.0f,4.0f };
 
 
 OutputFrame::OutputFrame(QWidget *parent) :
@@ -49,6 +52,10 @@ OutputFrame::OutputFrame(QWidget *parent) :
         ui->comboBoxImageFormat->addItem(name,format);
     }*/
     ui->widgetGridColor->setColor(QColor(255,0,255,255));
+    m_scale_boxes << ui->checkBoxScale0_5 << ui->checkBoxScale1
+                  << ui->checkBoxScale2 << ui->checkBoxScale3 << ui->checkBoxScale4;
+    foreach (QCheckBox* box, m_scale_boxes)
+        connect(box,SIGNAL(toggled(bool)),this,SLOT(onScalesToggled()));
 }
 
 OutputFrame::~OutputFrame()
@@ -72,24 +79,30 @@ void OutputFrame::setConfig(OutputConfig* config) {
     m_config = config;
     if (config) {
         ui->lineEditPath->setText(config->path());
-        connect(config,SIGNAL(imageNameChanged(QString)),this,SLOT(onImageNameChanged(QString)));
+        // set again when a project is loaded
+        connect(config,SIGNAL(imageNameChanged(QString)),this,SLOT(onImageNameChanged(QString)),Qt::UniqueConnection);
         onImageNameChanged(config->imageName());
-        connect(config,SIGNAL(descriptionNameChanged(QString)),this,SLOT(onDescriptionNameChanged(QString)));
+        connect(config,SIGNAL(descriptionNameChanged(QString)),this,SLOT(onDescriptionNameChanged(QString)),Qt::UniqueConnection);
         onDescriptionNameChanged(config->descriptionName());
-        for (int i=0;i<ui->comboBoxImageFormat->count();i++)
-            if (ui->comboBoxImageFormat->itemText(i)==config->imageFormat())
-                ui->comboBoxImageFormat->setCurrentIndex(i);
+        checkFormats(ui->listWidgetImageFormats,config->imageFormats());
         ui->groupBoxImage->setChecked(config->writeImage());
         if (ui->groupBoxDescription->isEnabled())
             ui->groupBoxDescription->setChecked(config->writeDescription());
         else
             config->setWriteDescription(false);
 
-        for (int i=0;i<ui->comboBoxDescriptionType->count();i++)
-            if (ui->comboBoxDescriptionType->itemText(i)==config->descriptionFormat())
-                ui->comboBoxDescriptionType->setCurrentIndex(i);
-        config->setDescriptionFormat(ui->comboBoxDescriptionType->currentText());
-        ui->checkBoxGenerateX2->setChecked(config->generateX2());
+        QStringList descriptions = config->descriptionFormats();
+        if (descriptions.isEmpty() && ui->listWidgetDescriptionFormats->count())
+            descriptions << ui->listWidgetDescriptionFormats->item(0)->text();
+        checkFormats(ui->listWidgetDescriptionFormats,descriptions);
+        config->setDescriptionFormats(checkedFormats(ui->listWidgetDescriptionFormats));
+        ui->checkBoxKerningClasses->setChecked(config->kerningClasses());
+        QList<float> list = config->scaleList();
+        for (int i=0;i<m_scale_boxes.size();i++) {
+            bool b = m_scale_boxes[i]->blockSignals(true);
+            m_scale_boxes[i]->setChecked(list.contains(scales[i]));
+            m_scale_boxes[i]->blockSignals(b);
+        }
     }
 }
 
@@ -122,9 +135,9 @@ void OutputFrame::on_lineEditDescriptionFilename_editingFinished()
     if (m_config) m_config->setDescriptionName(ui->lineEditDescriptionFilename->text());
 }
 
-void OutputFrame::on_comboBoxImageFormat_currentIndexChanged(QString name)
+void OutputFrame::on_listWidgetImageFormats_itemChanged(QListWidgetItem*)
 {
-    if (m_config) m_config->setImageFormat(name);
+    if (m_config) m_config->setImageFormats(checkedFormats(ui->listWidgetImageFormats));
 }
 
 void OutputFrame::on_groupBoxImage_toggled(bool checked)
@@ -137,32 +150,64 @@ void OutputFrame::on_groupBoxDescription_toggled(bool checked)
     if (m_config) m_config->setWriteDescription(checked);
 }
 
+void OutputFrame::on_checkBoxKerningClasses_toggled(bool checked)
+{
+    if (m_config) m_config->setKerningClasses(checked);
+}
+
 void OutputFrame::on_checkBoxDrawGrid_toggled(bool checked)
 {
     ui->widgetGridColor->setEnabled(checked);
 }
 
+void OutputFrame::setFormats(QListWidget* list,const QStringList& formats) {
+    bool bs = list->blockSignals(true);
+    list->clear();
+    foreach (const QString& format, formats) {
+        QListWidgetItem* item = new QListWidgetItem(format,list);
+        item->setFlags(Qt::ItemIsUserCheckable|Qt::ItemIsEnabled|Qt::ItemIsSelectable);
+        item->setCheckState(Qt::Unchecked);
+    }
+    list->blockSignals(bs);
+}
+
+void OutputFrame::checkFormats(QListWidget* list,const QStringList& formats) {
+    bool bs = list->blockSignals(true);
+    for (int i=0;i<list->count();i++) {
+        QListWidgetItem* item = list->item(i);
+        item->setCheckState(formats.contains(item->text()) ? Qt::Checked : Qt::Unchecked);
+    }
+    list->blockSignals(bs);
+}
+
+QStringList OutputFrame::checkedFormats(const QListWidget* list) {
+    QStringList formats;
+    for (int i=0;i<list->count();i++)
+        if (list->item(i)->checkState()==Qt::Checked)
+            formats.push_back(list->item(i)->text());
+    return formats;
+}
+
 void OutputFrame::setExporters(const QStringList& exporters) {
-    bool bs = ui->comboBoxDescriptionType->blockSignals(true);
-    ui->comboBoxDescriptionType->clear();
-    ui->comboBoxDescriptionType->addItems(exporters);
-    ui->comboBoxDescriptionType->blockSignals(bs);
+    setFormats(ui->listWidgetDescriptionFormats,exporters);
 }
 
 void OutputFrame::setImageWriters(const QStringList& writers) {
-    bool bs = ui->comboBoxImageFormat->blockSignals(true);
-    ui->comboBoxImageFormat->clear();
-    ui->comboBoxImageFormat->addItems(writers);
-    ui->comboBoxImageFormat->blockSignals(bs);
+    setFormats(ui->listWidgetImageFormats,writers);
 }
 
 
-void OutputFrame::on_comboBoxDescriptionType_currentIndexChanged(QString name)
+void OutputFrame::on_listWidgetDescriptionFormats_itemChanged(QListWidgetItem*)
 {
-    if (m_config) m_config->setDescriptionFormat(name);
+    if (m_config) m_config->setDescriptionFormats(checkedFormats(ui->listWidgetDescriptionFormats));
 }
 
-void OutputFrame::on_checkBoxGenerateX2_stateChanged(int arg1)
+void OutputFrame::onScalesToggled()
 {
-    if (m_config) m_config->setGenerateX2(arg1==Qt::Checked);
+    if (!m_config) return;
+    QList<float> list;
+    for (int i=0;i<m_scale_boxes.size();i++)
+        if (m_scale_boxes[i]->isChecked())
+            list.push_back(scales[i]);
+    m_config->setScaleList(list);
 }
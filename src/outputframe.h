@@ -32,12 +32,16 @@
 #define OUTPUTFRAME_H
 
 #include <QFrame>
+#include <QVector>
 
 namespace Ui {
     class OutputFrame;
 }
 
 class OutputConfig;
+class QCheckBox;
+class QListWidget;
+class QListWidgetItem;
 
 class OutputFrame : public QFrame {
     Q_OBJECT
@@ -55,20 +59,25 @@ protected:
 private:
     Ui::OutputFrame *ui;
     OutputConfig*   m_config;
+    QVector<QCheckBox*> m_scale_boxes;
+
+    static void setFormats(QListWidget* list,const QStringList& formats);
+    static void checkFormats(QListWidget* list,const QStringList& formats);
+    static QStringList checkedFormats(const QListWidget* list);
 
 private slots:
-    void on_comboBoxDescriptionType_currentIndexChanged(QString );
+    void on_listWidgetDescriptionFormats_itemChanged(QListWidgetItem* );
     void on_checkBoxDrawGrid_toggled(bool checked);
     void on_groupBoxDescription_toggled(bool );
+    void on_checkBoxKerningClasses_toggled(bool );
     void on_groupBoxImage_toggled(bool );
-    void on_comboBoxImageFormat_currentIndexChanged(QString );
+    void on_listWidgetImageFormats_itemChanged(QListWidgetItem* );
     void onImageNameChanged(const QString& s);
     void onDescriptionNameChanged(const QString& s);
     void on_lineEditImageFilename_editingFinished( );
     void on_lineEditDescriptionFilename_editingFinished( );
     void on_pushButtonSelectPath_clicked();
-
-    void on_checkBoxGenerateX2_stateChanged(int arg1);
+    void onScalesToggled();
 };
 
 #endif // OUTPUTFRAME_H
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perf.h"
+
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QString>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        int thread;
+        qint64 start_ns;
+        qint64 duration_ns;
+    };
+
+    struct Registry {
+        QMutex mutex;
+        QElapsedTimer clock;
+        QHash<QByteArray,Perf::Stage> stages;
+        QHash<QByteArray,qint64> counters;
+        bool tracing;
+        QVector<TraceEvent> events;
+        QHash<Qt::HANDLE,int> threads;
+        Registry() : tracing(false) { clock.start(); }
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    /// small stable ids, trace viewers show one row per thread
+    int threadId(Registry& r) {
+        Qt::HANDLE handle = QThread::currentThreadId();
+        QHash<Qt::HANDLE,int>::ConstIterator it = r.threads.constFind(handle);
+        if (it!=r.threads.constEnd())
+            return it.value();
+        int id = r.threads.size()+1;
+        r.threads.insert(handle,id);
+        return id;
+    }
+
+    QByteArray ms(qint64 ns) {
+        return QByteArray::number(double(ns)/1000000.0,'f',3);
+    }
+
+    QByteArray us(qint64 ns) {
+        return QByteArray::number(double(ns)/1000.0,'f',3);
+    }
+
+    /// names are literals of ours, only quotes and backslashes need escaping
+    QByteArray quoted(const QByteArray& name) {
+        QByteArray result = name;
+        result.replace('\\',"\\\\").replace('"',"\\\"");
+        return '"'+result+'"';
+    }
+}
+
+qint64 Perf::now() {
+    return registry().clock.nsecsElapsed();
+}
+
+void Perf::add(const char* stage,qint64 start_ns,qint64 duration_ns) {
+    Registry& r = registry();
+    const QByteArray key = QByteArray::fromRawData(stage,int(qstrlen(stage)));
+    QMutexLocker lock(&r.mutex);
+    QHash<QByteArray,Stage>::Iterator it = r.stages.find(key);
+    if (it==r.stages.end()) {
+        Stage s;
+        s.name = QByteArray(stage);
+        s.calls = 0;
+        s.total_ns = 0;
+        s.max_ns = 0;
+        it = r.stages.insert(s.name,s);
+    }
+    it->calls++;
+    it->total_ns += duration_ns;
+    if (duration_ns>it->max_ns)
+        it->max_ns = duration_ns;
+    if (r.tracing) {
+        TraceEvent event;
+        event.name = stage;
+        event.thread = threadId(r);
+        event.start_ns = start_ns;
+        event.duration_ns = duration_ns;
+        r.events.push_back(event);
+    }
+}
+
+void Perf::count(const char* counter,qint64 amount) {
+    Registry& r = registry();
+    const QByteArray key = QByteArray::fromRawData(counter,int(qstrlen(counter)));
+    QMutexLocker lock(&r.mutex);
+    QHash<QByteArray,qint64>::Iterator it = r.counters.find(key);
+    if (it==r.counters.end())
+        r.counters.insert(QByteArray(counter),amount);
+    else
+        it.value() += amount;
+}
+
+QList<Perf::Stage> Perf::stages() {
+    Registry& r = registry();
+    QMutexLocker lock(&r.mutex);
+    QMap<QByteArray,Stage> sorted;
+    foreach (const Stage& stage, r.stages)
+        sorted.insert(stage.name,stage);
+    return sorted.values();
+}
+
+QMap<QByteArray,qint64> Perf::counters() {
+    Registry& r = registry();
+    QMutexLocker lock(&r.mutex);
+    QMap<QByteArray,qint64> result;
+    for (QHash<QByteArray,qint64>::ConstIterator it = r.counters.begin();it!=r.counters.end();++it)
+        result.insert(it.key(),it.value());
+    return result;
+}
+
+void Perf::reset() {
+    Registry& r = registry();
+    QMutexLocker lock(&r.mutex);
+    r.stages.clear();
+    r.counters.clear();
+    r.events.clear();
+}
+
+void Perf::setTracing(bool tracing) {
+    Registry& r = registry();
+    QMutexLocker lock(&r.mutex);
+    r.tracing = tracing;
+    if (tracing)
+        r.events.reserve(r.events.size()+65536);
+}
+
+QByteArray Perf::json() {
+    QByteArray out = "{\n  \"stages\": [";
+    const QList<Stage> list = stages();
+    for (int i=0;i<list.size();i++) {
+        const Stage& s = list[i];
+        out += i ? ",\n" : "\n";
+        out += "    {\"name\": "+quoted(s.name)+
+               ", \"calls\": "+QByteArray::number(s.calls)+
+               ", \"total_ms\": "+ms(s.total_ns)+
+               ", \"max_ms\": "+ms(s.max_ns)+"}";
+    }
+    out += "\n  ],\n  \"counters\": {";
+    const QMap<QByteArray,qint64> values = counters();
+    for (QMap<QByteArray,qint64>::ConstIterator it = values.begin();it!=values.end();++it) {
+        out += it==values.begin() ? "\n" : ",\n";
+        out += "    "+quoted(it.key())+": "+QByteArray::number(it.value());
+    }
+    out += "\n  }\n}\n";
+    return out;
+}
+
+QByteArray Perf::chromeTrace() {
+    QVector<TraceEvent> events;
+    {
+        Registry& r = registry();
+        QMutexLocker lock(&r.mutex);
+        events = r.events;
+    }
+    QByteArray out = "{\"traceEvents\": [";
+    qint64 end = 0;
+    for (int i=0;i<events.size();i++) {
+        const TraceEvent& e = events[i];
+        out += i ? ",\n" : "\n";
+        out += "{\"name\": "+quoted(e.name)+", \"ph\": \"X\", \"pid\": 1"+
+               ", \"tid\": "+QByteArray::number(e.thread)+
+               ", \"ts\": "+us(e.start_ns)+", \"dur\": "+us(e.duration_ns)+"}";
+        end = qMax(end,e.start_ns+e.duration_ns);
+    }
+    /// totals as one counter sample at the end of the trace
+    const QMap<QByteArray,qint64> values = counters();
+    if (!values.isEmpty()) {
+        out += events.isEmpty() ? "\n" : ",\n";
+        out += "{\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"ts\": "+us(end)+", \"args\": {";
+        for (QMap<QByteArray,qint64>::ConstIterator it = values.begin();it!=values.end();++it) {
+            if (it!=values.begin())
+                out += ", ";
+            out += quoted(it.key())+": "+QByteArray::number(it.value());
+        }
+        out += "}}";
+    }
+    out += "\n]}\n";
+    return out;
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+
+/// Process wide timings of the pipeline stages and counters of the work
+/// they did. Recording takes a mutex and a hash lookup; a name allocates
+/// once, on its first use. Trace events are kept only while tracing is on,
+/// and then append to a vector reserved up front.
+class Perf
+{
+public:
+    struct Stage {
+        QByteArray name;
+        qint64 calls;
+        qint64 total_ns;
+        qint64 max_ns;
+    };
+
+    /// ns since the first call
+    static qint64 now();
+    /// stage names and counter names are string literals
+    static void add(const char* stage,qint64 start_ns,qint64 duration_ns);
+    static void count(const char* counter,qint64 amount = 1);
+
+    static QList<Stage> stages();
+    static QMap<QByteArray,qint64> counters();
+    static void reset();
+
+    static void setTracing(bool tracing);
+    /// stages and counters as a JSON object
+    static QByteArray json();
+    /// trace events in the Chrome trace event format, for chrome://tracing
+    static QByteArray chromeTrace();
+};
+
+/// adds the time until the end of the scope to a stage
+class PerfTimer
+{
+public:
+    explicit PerfTimer(const char* stage) : m_stage(stage),m_start(Perf::now()) {}
+    ~PerfTimer() { Perf::add(m_stage,m_start,Perf::now()-m_start); }
+private:
+    const char* m_stage;
+    qint64 m_start;
+};
+
+#endif // PERF_H
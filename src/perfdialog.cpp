@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perfdialog.h"
+#include "ui_perfdialog.h"
+#include "perf.h"
+
+/// ms between refreshes, the counters change with every pass
+static const int RefreshInterval = 500;
+
+PerfDialog::PerfDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::PerfDialog)
+{
+    ui->setupUi(this);
+    m_timer.setInterval(RefreshInterval);
+    connect(&m_timer,SIGNAL(timeout()),this,SLOT(refresh()));
+}
+
+PerfDialog::~PerfDialog()
+{
+    delete ui;
+}
+
+void PerfDialog::changeEvent(QEvent *e)
+{
+    QDialog::changeEvent(e);
+    switch (e->type()) {
+    case QEvent::LanguageChange:
+        ui->retranslateUi(this);
+        break;
+    default:
+        break;
+    }
+}
+
+void PerfDialog::showEvent(QShowEvent *e) {
+    QDialog::showEvent(e);
+    refresh();
+    m_timer.start();
+}
+
+void PerfDialog::hideEvent(QHideEvent *e) {
+    m_timer.stop();
+    QDialog::hideEvent(e);
+}
+
+static QString ms(qint64 ns) {
+    return QString::number(double(ns)/1000000.0,'f',2);
+}
+
+void PerfDialog::refresh() {
+    ui->treeWidget->clear();
+    foreach (const Perf::Stage& stage, Perf::stages()) {
+        QTreeWidgetItem* item = new QTreeWidgetItem(ui->treeWidget);
+        item->setText(0,QString::fromLatin1(stage.name));
+        item->setText(1,QString::number(stage.calls));
+        item->setText(2,ms(stage.total_ns));
+        item->setText(3,ms(stage.calls ? stage.total_ns/stage.calls : 0));
+        item->setText(4,ms(stage.max_ns));
+        for (int i=1;i<5;i++)
+            item->setTextAlignment(i,Qt::AlignRight);
+    }
+    const QMap<QByteArray,qint64> counters = Perf::counters();
+    for (QMap<QByteArray,qint64>::ConstIterator it = counters.begin();it!=counters.end();++it) {
+        QTreeWidgetItem* item = new QTreeWidgetItem(ui->treeWidget);
+        item->setText(0,QString::fromLatin1(it.key()));
+        item->setText(1,QString::number(it.value()));
+        item->setTextAlignment(1,Qt::AlignRight);
+    }
+    ui->treeWidget->resizeColumnToContents(0);
+}
+
+void PerfDialog::on_pushButtonReset_clicked()
+{
+    Perf::reset();
+    refresh();
+}
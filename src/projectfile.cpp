@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "projectfile.h"
+#include "fontconfig.h"
+#include "layoutconfig.h"
+#include "outputconfig.h"
+#include "atomicfile.h"
+#include "exporters/xmlwriter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QDomDocument>
+#include <QMetaProperty>
+#include <QStringList>
+
+/// bump when the meaning of stored values changes
+static const int ProjectVersion = 1;
+
+ProjectFile::ProjectFile() : m_locked()
+{
+}
+
+namespace {
+    /// own properties only, objectName is not part of a config
+    void writeConfig(XmlWriter& xml,const char* group,const QObject* object,const QDir& dir) {
+        xml.startElement(group);
+        const QMetaObject *metaobject = object->metaObject();
+        for (int i=metaobject->propertyOffset();i<metaobject->propertyCount();i++) {
+            QMetaProperty metaproperty = metaobject->property(i);
+            if (!metaproperty.isWritable())
+                continue;
+            const char* name = metaproperty.name();
+            const QVariant value = object->property(name);
+            xml.startElement("property");
+            xml.attribute("name",name);
+            if (value.type()==QVariant::StringList) {
+                foreach (const QString& item, value.toStringList()) {
+                    xml.startElement("item");
+                    xml.attribute("value",item);
+                    xml.endElement();
+                }
+            } else {
+                QString text = value.toString();
+                if (qstrcmp(name,"path")==0 && !text.isEmpty())
+                    text = dir.relativeFilePath(text);
+                xml.attribute("value",text);
+            }
+            xml.endElement();
+        }
+        xml.endElement();
+    }
+
+    void writeLocked(XmlWriter& xml,const RendererData& rendered) {
+        xml.startElement("locked");
+        for (QMap<uint,RenderedChar>::ConstIterator it = rendered.chars.begin();it!=rendered.chars.end();++it) {
+            if (!it->locked)
+                continue;
+            QByteArray png;
+            if (!it->img.isNull()) {
+                QBuffer buffer(&png);
+                buffer.open(QIODevice::WriteOnly);
+                it->img.save(&buffer,"PNG");
+            }
+            xml.startElement("char");
+            xml.attribute("code",int(it.key()));
+            xml.attribute("offsetX",it->offsetX);
+            xml.attribute("offsetY",it->offsetY);
+            xml.attribute("advance",it->advance);
+            xml.attribute("advance64",it->advance64);
+            xml.attribute("image",png.toBase64().constData());
+            for (QMap<uint,int>::ConstIterator k = it->kerning.begin();k!=it->kerning.end();++k) {
+                xml.startElement("kerning");
+                xml.attribute("code",int(k.key()));
+                xml.attribute("amount",k.value());
+                xml.attribute("amount64",it->kerning64.value(k.key()));
+                xml.endElement();
+            }
+            xml.endElement();
+        }
+        xml.endElement();
+    }
+}
+
+bool ProjectFile::Save(const QString& filename,const FontConfig* font,const LayoutConfig* layout,
+                       const OutputConfig* output,const RendererData& rendered) {
+    const QDir dir = QFileInfo(filename).absoluteDir();
+    QByteArray data;
+    {
+        XmlWriter xml(data);
+        xml.writeDeclaration();
+        xml.startElement("fontbuilder");
+        xml.attribute("version",ProjectVersion);
+        writeConfig(xml,"fontconfig",font,dir);
+        writeConfig(xml,"layoutconfig",layout,dir);
+        writeConfig(xml,"outputconfig",output,dir);
+        writeLocked(xml,rendered);
+    }
+    AtomicFile file(filename);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data)!=data.size() || !file.commit()) {
+        m_error_string = tr("Error writing file :")+filename+"\n"+file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ProjectFile::Load(const QString& filename) {
+    m_groups.clear();
+    m_locked = RendererData();
+    m_error_string = QString();
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+        m_error_string = tr("Error opening file :")+filename;
+        return false;
+    }
+    QDomDocument doc;
+    QString error;
+    int line = 0;
+    if (!doc.setContent(&file,&error,&line)) {
+        m_error_string = tr("%1:%2: %3").arg(filename).arg(line).arg(error);
+        return false;
+    }
+    QDomElement root = doc.firstChildElement("fontbuilder");
+    if (root.isNull()) {
+        m_error_string = tr("Not a project file :")+filename;
+        return false;
+    }
+    if (root.attribute("version").toInt()>ProjectVersion) {
+        m_error_string = tr("Project was saved by a newer version :")+filename;
+        return false;
+    }
+    m_dir = QFileInfo(filename).absolutePath();
+
+    static const char* groups[] = { "fontconfig","layoutconfig","outputconfig" };
+    for (size_t i=0;i<sizeof(groups)/sizeof(groups[0]);i++) {
+        QVariantMap& values = m_groups[groups[i]];
+        QDomElement group = root.firstChildElement(groups[i]);
+        for (QDomElement p = group.firstChildElement("property");!p.isNull();p = p.nextSiblingElement("property")) {
+            if (p.hasAttribute("value")) {
+                values[p.attribute("name")] = p.attribute("value");
+            } else {
+                QStringList items;
+                for (QDomElement item = p.firstChildElement("item");!item.isNull();item = item.nextSiblingElement("item"))
+                    items << item.attribute("value");
+                values[p.attribute("name")] = items;
+            }
+        }
+    }
+
+    QDomElement locked = root.firstChildElement("locked");
+    for (QDomElement c = locked.firstChildElement("char");!c.isNull();c = c.nextSiblingElement("char")) {
+        const uint code = c.attribute("code").toUInt();
+        const QByteArray png = QByteArray::fromBase64(c.attribute("image").toLatin1());
+        QImage img;
+        if (!png.isEmpty()) {
+            img = QImage::fromData(png,"PNG");
+            if (img.isNull()) {
+                m_error_string = tr("Invalid image of locked char %1").arg(code);
+                m_groups.clear();
+                m_locked = RendererData();
+                return false;
+            }
+            img = img.convertToFormat(QImage::Format_ARGB32);
+        }
+        RenderedChar rc(code,c.attribute("offsetX").toInt(),c.attribute("offsetY").toInt(),
+                        c.attribute("advance").toInt(),img);
+        rc.advance64 = c.attribute("advance64").toInt();
+        for (QDomElement k = c.firstChildElement("kerning");!k.isNull();k = k.nextSiblingElement("kerning")) {
+            const uint second = k.attribute("code").toUInt();
+            rc.kerning[second] = k.attribute("amount").toInt();
+            rc.kerning64[second] = k.attribute("amount64").toInt();
+        }
+        rc.locked = true;
+        m_locked.chars[code] = rc;
+    }
+    return true;
+}
+
+void ProjectFile::apply(const QString& group,QObject* object) const {
+    const QVariantMap values = m_groups.value(group);
+    const QMetaObject *metaobject = object->metaObject();
+    for (int i=metaobject->propertyOffset();i<metaobject->propertyCount();i++) {
+        const char* name = metaobject->property(i).name();
+        QVariantMap::ConstIterator it = values.find(name);
+        if (it==values.end())
+            continue;
+        QVariant value = *it;
+        if (qstrcmp(name,"path")==0 && !value.toString().isEmpty())
+            value = QDir::cleanPath(QDir(m_dir).absoluteFilePath(value.toString()));
+        object->setProperty(name,value);
+    }
+}
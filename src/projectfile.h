@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PROJECTFILE_H
+#define PROJECTFILE_H
+
+#include <QCoreApplication>
+#include <QString>
+#include <QMap>
+#include <QVariant>
+
+#include "rendererdata.h"
+
+class QObject;
+class FontConfig;
+class LayoutConfig;
+class OutputConfig;
+
+/// Font, layout and output configs plus locked glyphs in one XML file,
+/// independent of the QSettings state. Paths are stored relative to the
+/// project file, so a project can move between machines and drive both
+/// the GUI and batch builds.
+class ProjectFile
+{
+    Q_DECLARE_TR_FUNCTIONS(ProjectFile)
+public:
+    ProjectFile();
+
+    bool Save(const QString& filename,const FontConfig* font,const LayoutConfig* layout,
+              const OutputConfig* output,const RendererData& rendered);
+    /// reads the whole file, configs are changed only by apply()
+    bool Load(const QString& filename);
+    /// sets the properties stored for group ("fontconfig", "layoutconfig"
+    /// or "outputconfig") in declaration order, like the settings are read
+    void apply(const QString& group,QObject* object) const;
+    /// locked glyphs of the loaded project, for FontRenderer::LoadLocked
+    const RendererData& locked() const { return m_locked;}
+    const QString& errorString() const { return m_error_string;}
+private:
+    QString m_dir;
+    QMap<QString,QVariantMap> m_groups;
+    RendererData m_locked;
+    QString m_error_string;
+};
+
+#endif // PROJECTFILE_H
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bmfontreader.h"
+
+#include <cstring>
+
+BMFontReader::BMFontReader(QObject *parent) :
+    AbstractReader(parent)
+{
+}
+
+namespace {
+    /// key=value pairs of one line, values may be quoted
+    class LineScanner {
+    public:
+        LineScanner(const char* begin,const char* end) : m_p(begin),m_end(end) {}
+        bool next() {
+            while (m_p<m_end && (*m_p==' ' || *m_p=='\t' || *m_p=='\r')) m_p++;
+            if (m_p>=m_end) return false;
+            key = m_p;
+            while (m_p<m_end && *m_p!='=' && *m_p!=' ') m_p++;
+            key_end = m_p;
+            value = value_end = m_p;
+            if (m_p<m_end && *m_p=='=') {
+                m_p++;
+                if (m_p<m_end && *m_p=='"') {
+                    value = ++m_p;
+                    while (m_p<m_end && *m_p!='"') m_p++;
+                    value_end = m_p;
+                    if (m_p<m_end) m_p++;
+                } else {
+                    value = m_p;
+                    while (m_p<m_end && *m_p!=' ' && *m_p!='\t' && *m_p!='\r') m_p++;
+                    value_end = m_p;
+                }
+            }
+            return true;
+        }
+        bool is(const char* name) const {
+            return int(::strlen(name))==key_end-key && ::memcmp(key,name,key_end-key)==0;
+        }
+        QString text() const { return QString::fromUtf8(value,int(value_end-value));}
+        const char* key;
+        const char* key_end;
+        const char* value;
+        const char* value_end;
+    private:
+        const char* m_p;
+        const char* m_end;
+    };
+}
+
+bool BMFontReader::Import(const QByteArray& data) {
+    const char* p = data.constData();
+    const char* end = p+data.size();
+    int base = 0;
+    int line = 0;
+    while (p<end) {
+        const char* eol = static_cast<const char*>(::memchr(p,'\n',end-p));
+        if (!eol) eol = end;
+        line++;
+        LineScanner s(p,eol);
+        p = eol+1;
+        if (!s.next())
+            continue;
+        bool ok = true;
+        int v = 0;
+        if (s.is("info")) {
+            while (s.next()) {
+                if (s.is("face")) setFamily(s.text());
+                else if (s.is("size") && (ok = toInt(s.value,s.value_end,v))) setSize(v);
+            }
+        } else if (s.is("common")) {
+            int w = 0,h = 0;
+            while (s.next() && ok) {
+                if (s.is("lineHeight") && (ok = toInt(s.value,s.value_end,v))) setLineHeight(v);
+                else if (s.is("base")) ok = toInt(s.value,s.value_end,base);
+                else if (s.is("scaleW")) ok = toInt(s.value,s.value_end,w);
+                else if (s.is("scaleH")) ok = toInt(s.value,s.value_end,h);
+            }
+            setAscender(base);
+            setTextureSize(w,h);
+        } else if (s.is("page")) {
+            while (s.next())
+                if (s.is("file")) setTexture(s.text());
+        } else if (s.is("char")) {
+            Symbol& c = addSymbol(0);
+            while (s.next() && ok) {
+                if (s.is("id")) { ok = toInt(s.value,s.value_end,v); c.id = uint(v); }
+                else if (s.is("x")) ok = toInt(s.value,s.value_end,c.placeX);
+                else if (s.is("y")) ok = toInt(s.value,s.value_end,c.placeY);
+                else if (s.is("width")) ok = toInt(s.value,s.value_end,c.placeW);
+                else if (s.is("height")) ok = toInt(s.value,s.value_end,c.placeH);
+                else if (s.is("xoffset")) ok = toInt(s.value,s.value_end,c.offsetX);
+                else if (s.is("yoffset")) ok = toInt(s.value,s.value_end,c.offsetY);
+                else if (s.is("xadvance")) ok = toInt(s.value,s.value_end,c.advance);
+            }
+        } else if (s.is("kerning")) {
+            int first = 0,second = 0,amount = 0;
+            while (s.next() && ok) {
+                if (s.is("first")) ok = toInt(s.value,s.value_end,first);
+                else if (s.is("second")) ok = toInt(s.value,s.value_end,second);
+                else if (s.is("amount")) ok = toInt(s.value,s.value_end,amount);
+            }
+            addKerning(uint(first),uint(second),amount);
+        }
+        if (!ok) {
+            setErrorMessage(QString("Invalid number at line %1").arg(line));
+            return false;
+        }
+    }
+    // written as yoffset = base - offsetY
+    QVector<Symbol>& symbols = editSymbols();
+    for (int i=0;i<symbols.size();i++)
+        symbols[i].offsetY = base - symbols[i].offsetY;
+    return true;
+}
+
+
+AbstractReader* BMFontReaderFactoryFunc (QObject* parent) {
+    return new BMFontReader(parent);
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ghlreader.h"
+
+#include <QDomDocument>
+#include <QStringList>
+
+GHLReader::GHLReader(QObject *parent) :
+    AbstractReader(parent)
+{
+}
+
+namespace {
+    /// space separated integers of rect and offset attributes
+    bool toInts(const QString& text,int* values,int count) {
+        QStringList parts = text.split(' ',QString::SkipEmptyParts);
+        if (parts.size()!=count)
+            return false;
+        bool ok = true;
+        for (int i=0;i<count && ok;i++)
+            values[i] = parts[i].toInt(&ok);
+        return ok;
+    }
+
+    uint charCode(const QString& text) {
+        if (text.size()>1 && text[0].isHighSurrogate() && text[1].isLowSurrogate())
+            return QChar::surrogateToUcs4(text[0],text[1]);
+        return text.isEmpty() ? 0 : text[0].unicode();
+    }
+}
+
+bool GHLReader::Import(const QByteArray& data) {
+    QDomDocument doc;
+    QString error;
+    if (!doc.setContent(data,&error)) {
+        setErrorMessage(error);
+        return false;
+    }
+    QDomElement root = doc.firstChildElement("font");
+    if (root.isNull()) {
+        setErrorMessage("No font element");
+        return false;
+    }
+    QDomElement description = root.firstChildElement("description");
+    setFamily(description.attribute("family"));
+    setSize(description.attribute("size").toInt());
+    QDomElement metrics = root.firstChildElement("metrics");
+    setLineHeight(metrics.attribute("height").toInt());
+    setAscender(metrics.attribute("ascender").toInt());
+    QDomElement texture = root.firstChildElement("texture");
+    setTexture(texture.attribute("file"));
+    setTextureSize(texture.attribute("width").toInt(),texture.attribute("height").toInt());
+
+    QDomElement chars = root.firstChildElement("chars");
+    for (QDomElement c = chars.firstChildElement("char");!c.isNull();c = c.nextSiblingElement("char")) {
+        Symbol& symb = addSymbol(charCode(c.attribute("id")));
+        int rect[4];
+        int offset[2];
+        if (!toInts(c.attribute("rect"),rect,4) || !toInts(c.attribute("offset"),offset,2)) {
+            setErrorMessage(QString("Invalid char %1").arg(symb.id));
+            return false;
+        }
+        symb.placeX = rect[0];
+        symb.placeY = rect[1];
+        symb.placeW = rect[2];
+        symb.placeH = rect[3];
+        symb.offsetX = offset[0];
+        symb.offsetY = offset[1];
+        symb.advance = c.attribute("advance").toInt();
+        uint first = symb.id;
+        for (QDomElement k = c.firstChildElement("kerning");!k.isNull();k = k.nextSiblingElement("kerning"))
+            addKerning(first,charCode(k.attribute("id")),k.attribute("advance").toInt());
+    }
+    return true;
+}
+
+
+AbstractReader* GHLReaderFactoryFunc (QObject* parent) {
+    return new GHLReader(parent);
+}
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "luareader.h"
+
+#include <QVariant>
+#include <QVariantMap>
+
+LuaReader::LuaReader(QObject *parent) :
+    AbstractReader(parent)
+{
+}
+
+namespace {
+    /// Lua literal subset the exporter writes: strings, numbers and
+    /// tables. Tables become maps, positional items are kept as a list
+    /// under the empty key.
+    class LuaParser {
+    public:
+        explicit LuaParser(const QByteArray& data) :
+            m_p(data.constData()),m_end(data.constData()+data.size()) {}
+
+        /// a returned table or a chunk of top level assignments
+        bool parse(QVariantMap& result) {
+            skip();
+            if (word("return")) {
+                QVariant value;
+                if (!table(value)) return false;
+                result = value.toMap();
+                skip();
+                return m_p>=m_end;
+            }
+            while (skip(),m_p<m_end) {
+                QString key = name();
+                if (key.isEmpty() || !expect('=')) return false;
+                QVariant value;
+                if (!this->value(value)) return false;
+                result[key] = value;
+            }
+            return true;
+        }
+    private:
+        void skip() {
+            for (;;) {
+                while (m_p<m_end && (*m_p==' ' || *m_p=='\t' || *m_p=='\r' || *m_p=='\n')) m_p++;
+                if (m_end-m_p>=2 && m_p[0]=='-' && m_p[1]=='-') {
+                    while (m_p<m_end && *m_p!='\n') m_p++;
+                    continue;
+                }
+                return;
+            }
+        }
+        static bool isName(char c,bool first) {
+            return (c>='a' && c<='z') || (c>='A' && c<='Z') || c=='_' || (!first && c>='0' && c<='9');
+        }
+        bool word(const char* w) {
+            const char* p = m_p;
+            for (;*w;w++,p++)
+                if (p>=m_end || *p!=*w) return false;
+            if (p<m_end && isName(*p,false)) return false;
+            m_p = p;
+            return true;
+        }
+        bool expect(char c) {
+            skip();
+            if (m_p>=m_end || *m_p!=c) return false;
+            m_p++;
+            return true;
+        }
+        QString name() {
+            const char* begin = m_p;
+            if (m_p<m_end && isName(*m_p,true))
+                while (m_p<m_end && isName(*m_p,false)) m_p++;
+            return QString::fromLatin1(begin,int(m_p-begin));
+        }
+        bool string(QVariant& value) {
+            char quote = *m_p++;
+            QByteArray bytes;
+            while (m_p<m_end && *m_p!=quote) {
+                if (*m_p=='\\' && m_p+1<m_end) m_p++;
+                bytes.append(*m_p++);
+            }
+            if (m_p>=m_end) return false;
+            m_p++;
+            value = QString::fromUtf8(bytes.constData(),bytes.size());
+            return true;
+        }
+        bool number(QVariant& value) {
+            const char* begin = m_p;
+            while (m_p<m_end && ((*m_p>='0' && *m_p<='9') || *m_p=='-' || *m_p=='+'
+                                 || *m_p=='.' || *m_p=='e' || *m_p=='E')) m_p++;
+            bool ok = false;
+            double number = QByteArray(begin,int(m_p-begin)).toDouble(&ok);
+            value = number;
+            return ok;
+        }
+        bool table(QVariant& value) {
+            if (!expect('{')) return false;
+            QVariantMap map;
+            QVariantList items;
+            for (;;) {
+                skip();
+                if (m_p>=m_end) return false;
+                if (*m_p=='}') { m_p++; break; }
+                QVariant key;
+                if (*m_p=='[') {
+                    m_p++;
+                    if (!this->value(key) || !expect(']') || !expect('=')) return false;
+                } else if (isName(*m_p,true)) {
+                    const char* save = m_p;
+                    key = name();
+                    if (!expect('=')) { m_p = save; key = QVariant(); }
+                }
+                QVariant item;
+                if (!this->value(item)) return false;
+                if (key.isValid())
+                    map[key.toString()] = item;
+                else
+                    items.push_back(item);
+                skip();
+                if (m_p<m_end && (*m_p==',' || *m_p==';')) m_p++;
+            }
+            if (!items.isEmpty())
+                map[QString()] = items;
+            value = map;
+            return true;
+        }
+        bool value(QVariant& value) {
+            skip();
+            if (m_p>=m_end) return false;
+            if (*m_p=='"' || *m_p=='\'') return string(value);
+            if (*m_p=='{') return table(value);
+            return number(value);
+        }
+        const char* m_p;
+        const char* m_end;
+    };
+
+    uint charCode(const QVariant& value) {
+        QString text = value.toString();
+        if (text.isEmpty())
+            return 0;
+        if (text.size()>1 && text[0].isHighSurrogate() && text[1].isLowSurrogate())
+            return QChar::surrogateToUcs4(text[0],text[1]);
+        return text[0].unicode();
+    }
+
+    int toInt(const QVariant& value) {
+        return qRound(value.toDouble());
+    }
+}
+
+bool LuaReader::Import(const QByteArray& data) {
+    QVariantMap root;
+    if (!LuaParser(data).parse(root)) {
+        setErrorMessage("Invalid Lua table");
+        return false;
+    }
+    QVariantMap description = root.value("description").toMap();
+    setFamily(description.value("family").toString());
+    setSize(toInt(description.value("size")));
+    setLineHeight(toInt(root.value("height")));
+    setAscender(toInt(root.value("metrics").toMap().value("ascender")));
+    QVariantMap texture = root.value("texture").toMap();
+    setTexture(texture.contains("file") ? texture.value("file").toString() : root.value("file").toString());
+    setTextureSize(toInt(texture.value("width")),toInt(texture.value("height")));
+
+    foreach (const QVariant& item,root.value("chars").toMap().value(QString()).toList()) {
+        QVariantMap c = item.toMap();
+        Symbol& symb = addSymbol(charCode(c.value("char")));
+        symb.advance = toInt(c.value("width"));
+        symb.placeX = toInt(c.value("x"));
+        symb.placeY = toInt(c.value("y"));
+        symb.placeW = toInt(c.value("w"));
+        symb.placeH = toInt(c.value("h"));
+        symb.offsetX = toInt(c.value("ox"));
+        symb.offsetY = toInt(c.value("oy"));
+    }
+
+    foreach (const QVariant& item,root.value("kernings").toMap().value(QString()).toList()) {
+        QVariantMap k = item.toMap();
+        addKerning(charCode(k.value("from")),charCode(k.value("to")),toInt(k.value("offset")));
+    }
+
+    if (root.contains("kerningClasses")) {
+        // expand the class matrix back to the pairs it was built from
+        QVariantMap classes = root.value("kerningClasses").toMap();
+        QVariantMap left = classes.value("left").toMap();
+        QVariantMap right = classes.value("right").toMap();
+        QVariantList rows = classes.value("matrix").toMap().value(QString()).toList();
+        QVector<QVector<int> > matrix(rows.size());
+        for (int l=0;l<rows.size();l++)
+            foreach (const QVariant& amount,rows[l].toMap().value(QString()).toList())
+                matrix[l].push_back(toInt(amount));
+        for (QVariantMap::ConstIterator a = left.begin();a!=left.end();++a) {
+            int l = toInt(a.value());
+            // class 0 is every glyph without kerning
+            if (l<=0 || l>=matrix.size()) continue;
+            for (QVariantMap::ConstIterator b = right.begin();b!=right.end();++b) {
+                int r = toInt(b.value());
+                if (r<0 || r>=matrix[l].size() || matrix[l][r]==0) continue;
+                addKerning(charCode(a.key()),charCode(b.key()),matrix[l][r]);
+            }
+        }
+    }
+    return true;
+}
+
+
+AbstractReader* LuaReaderFactoryFunc (QObject* parent) {
+    return new LuaReader(parent);
+}
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "simplereader.h"
+
+#include <cstring>
+
+SimpleReader::SimpleReader(QObject *parent) :
+    AbstractReader(parent)
+{
+}
+
+namespace {
+    /// header lines, then whitespace separated numbers
+    class Scanner {
+    public:
+        explicit Scanner(const QByteArray& data) : m_p(data.constData()),m_end(data.constData()+data.size()) {}
+        QString line() {
+            const char* eol = static_cast<const char*>(::memchr(m_p,'\n',m_end-m_p));
+            if (!eol) eol = m_end;
+            QString text = QString::fromUtf8(m_p,int(eol-m_p));
+            m_p = eol<m_end ? eol+1 : m_end;
+            return text;
+        }
+        bool number(int& value) {
+            while (m_p<m_end && isSpace(*m_p)) m_p++;
+            const char* begin = m_p;
+            while (m_p<m_end && !isSpace(*m_p)) m_p++;
+            return AbstractReader::toInt(begin,m_p,value);
+        }
+    private:
+        static bool isSpace(char c) { return c==' ' || c=='\n' || c=='\r' || c=='\t'; }
+        const char* m_p;
+        const char* m_end;
+    };
+}
+
+bool SimpleReader::Import(const QByteArray& data) {
+    Scanner s(data);
+    setFamily(s.line());
+    int size = 0,height = 0;
+    if (!s.number(size) || !s.number(height)) {
+        setErrorMessage("Invalid header");
+        return false;
+    }
+    setSize(size);
+    setLineHeight(height);
+    s.line();
+    setTexture(s.line());
+
+    int count = 0;
+    if (!s.number(count) || count<0) {
+        setErrorMessage("Invalid symbols count");
+        return false;
+    }
+    editSymbols().reserve(count);
+    for (int i=0;i<count;i++) {
+        int id = 0;
+        bool ok = s.number(id);
+        Symbol& c = addSymbol(uint(id));
+        ok = ok && s.number(c.placeX) && s.number(c.placeY) && s.number(c.placeW) && s.number(c.placeH)
+                && s.number(c.offsetX) && s.number(c.offsetY) && s.number(c.advance);
+        if (!ok) {
+            setErrorMessage(QString("Invalid symbol %1").arg(i));
+            return false;
+        }
+        // written as line height - offsetY
+        c.offsetY = height - c.offsetY;
+    }
+
+    if (!s.number(count) || count<0) {
+        setErrorMessage("Invalid kernings count");
+        return false;
+    }
+    for (int i=0;i<count;i++) {
+        int first = 0,second = 0,amount = 0;
+        if (!s.number(first) || !s.number(second) || !s.number(amount)) {
+            setErrorMessage(QString("Invalid kerning %1").arg(i));
+            return false;
+        }
+        addKerning(uint(first),uint(second),amount);
+    }
+    return true;
+}
+
+
+AbstractReader* SimpleReaderFactoryFunc (QObject* parent) {
+    return new SimpleReader(parent);
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "zfireader.h"
+
+#include <cstring>
+
+ZFIReader::ZFIReader(QObject *parent) :
+    AbstractReader(parent)
+{
+}
+
+namespace {
+    /// host endian fields, like the exporter writes them
+    template <class T>
+    T take(const char*& p) {
+        T value;
+        ::memcpy(&value,p,sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+}
+
+bool ZFIReader::Import(const QByteArray& data) {
+    const int header_size = 13+2+2+4+4+4;
+    const int char_size = 4+4+1+1+4+4+4+8*4;
+    if (data.size()<header_size || !data.startsWith("ZGL_FONT_INFO")) {
+        setErrorMessage("Not a ZenGL font");
+        return false;
+    }
+    const char* p = data.constData()+13;
+    take<quint16>(p);   // pages
+    int chars = take<quint16>(p);
+    p += 4+4+4;         // max height, max shift, padding
+    if (data.size()<header_size+chars*char_size) {
+        setErrorMessage("Truncated symbols table");
+        return false;
+    }
+    setFields(Placement|Offsets|Advance);
+
+    int page_width = 0,page_height = 0;
+    QVector<float> origins(chars*2);
+    editSymbols().reserve(chars);
+    for (int i=0;i<chars;i++) {
+        Symbol& c = addSymbol(uint(take<qint32>(p)));
+        p += 4;
+        c.placeW = quint8(take<char>(p));
+        c.placeH = quint8(take<char>(p));
+        c.offsetX = take<qint32>(p);
+        c.offsetY = c.placeH - take<qint32>(p);
+        c.advance = take<qint32>(p);
+        float tc[8];
+        for (int j=0;j<8;j++)
+            tc[j] = take<float>(p);
+        origins[i*2] = tc[0];
+        origins[i*2+1] = tc[1];
+        // the page size is only stored in the texture coordinates
+        if (!page_width && tc[2]>tc[0])
+            page_width = qRound(c.placeW/(tc[2]-tc[0]));
+        if (!page_height && tc[1]>tc[5])
+            page_height = qRound(c.placeH/(tc[1]-tc[5]));
+    }
+    for (int i=0;i<chars;i++) {
+        Symbol& c = editSymbols()[i];
+        c.placeX = qRound(origins[i*2]*page_width);
+        c.placeY = qRound((1-origins[i*2+1])*page_height);
+    }
+    setTextureSize(page_width,page_height);
+    return true;
+}
+
+
+AbstractReader* ZFIReaderFactoryFunc (QObject* parent) {
+    return new ZFIReader(parent);
+}
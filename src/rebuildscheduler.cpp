@@ -0,0 +1,292 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "rebuildscheduler.h"
+#include "fontconfig.h"
+#include "fontrenderer.h"
+#include "layoutconfig.h"
+#include "layoutdata.h"
+#include "layouterfactory.h"
+#include "abstractlayouter.h"
+#include "abstractimagewriter.h"
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QMetaProperty>
+#include <QDebug>
+#include <QtConcurrentRun>
+
+/// a frame, changes arriving closer together end up in one pass
+static const int CoalesceInterval = 16;
+/// ms between snapshots of a long render, shorter passes show none
+static const int PublishInterval = 150;
+
+static void copyConfig(const QObject* from,QObject* to) {
+    const QMetaObject *metaobject = from->metaObject();
+    int count = metaobject->propertyCount();
+    for (int i=0; i<count; ++i) {
+        QMetaProperty metaproperty = metaobject->property(i);
+        if (!metaproperty.isWritable())
+            continue;
+        const char *name = metaproperty.name();
+        to->setProperty(name,from->property(name));
+    }
+}
+
+/// Copies of everything a pass reads, so the worker never touches
+/// objects the GUI keeps changing.
+struct RebuildScheduler::Pass {
+    int generation;
+    bool render;
+    FontConfig font;
+    LayoutConfig layout;
+    /// locked glyphs on input when rendering, the previous render otherwise
+    RendererData rendered;
+    QVector<LayoutChar> chars;
+    LayoutData data;
+    QAtomicInt cancel;
+    RebuildScheduler* scheduler;
+    /// width the snapshots are packed to, the last atlas width
+    int preview_width;
+    /// latest snapshot, written by the worker and taken by the GUI
+    QMutex partial_mutex;
+    RendererData partial_rendered;
+    QVector<LayoutChar> partial_placed;
+    QImage partial_image;
+
+    Pass() : generation(0),render(false),cancel(0),scheduler(0),preview_width(0),partial_rendered() {}
+    bool isCancelled() { return cancel.fetchAndAddOrdered(0)!=0;}
+};
+
+RebuildScheduler::RebuildScheduler(QObject *parent,const FontConfig* font,const LayoutConfig* layout,LayoutData* data) :
+    QObject(parent), m_font_config(font), m_layout_config(layout), m_layout_data(data),
+    m_rendered(), m_locked(), m_render_dirty(false), m_layout_dirty(false), m_generation(0)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(CoalesceInterval);
+    connect(&m_timer,SIGNAL(timeout()),this,SLOT(start()));
+    connect(&m_watcher,SIGNAL(finished()),this,SLOT(onPassFinished()));
+
+    connect(font,SIGNAL(fileChanged()),this,SLOT(scheduleRender()));
+    connect(font,SIGNAL(faceIndexChanged()),this,SLOT(scheduleRender()));
+    connect(font,SIGNAL(sizeChanged()),this,SLOT(scheduleRender()));
+    connect(font,SIGNAL(charactersChanged()),this,SLOT(scheduleRender()));
+    connect(font,SIGNAL(renderingOptionsChanged()),this,SLOT(scheduleRender()));
+    connect(layout,SIGNAL(layoutConfigChanged()),this,SLOT(scheduleLayout()));
+}
+
+RebuildScheduler::~RebuildScheduler() {
+    m_watcher.disconnect(this);
+    cancelPass();
+    m_watcher.waitForFinished();
+}
+
+void RebuildScheduler::setLocked(const RendererData& locked) {
+    m_locked = locked;
+    scheduleRender();
+}
+
+/// the running pass reads settings that are stale now, what it was
+/// asked to do is done again by the next one
+void RebuildScheduler::cancelPass() {
+    if (m_pass) {
+        m_pass->cancel.fetchAndStoreOrdered(1);
+        m_render_dirty = m_render_dirty || m_pass->render;
+        m_layout_dirty = true;
+    }
+}
+
+void RebuildScheduler::scheduleRender() {
+    cancelPass();
+    m_render_dirty = true;
+    m_layout_dirty = true;
+    m_timer.start();
+}
+
+void RebuildScheduler::scheduleLayout() {
+    cancelPass();
+    m_layout_dirty = true;
+    m_timer.start();
+}
+
+void RebuildScheduler::start() {
+    /// a cancelled pass ends soon, the next one starts when it has
+    if (m_watcher.isRunning())
+        return;
+    if (!(m_render_dirty || m_layout_dirty)) {
+        if (!m_pass)
+            finished();
+        return;
+    }
+    QSharedPointer<Pass> pass(new Pass());
+    pass->generation = ++m_generation;
+    pass->render = m_render_dirty;
+    pass->scheduler = this;
+    pass->preview_width = qMax(m_layout_data->width(),256);
+    copyConfig(m_font_config,&pass->font);
+    copyConfig(m_layout_config,&pass->layout);
+    if (pass->render) {
+        pass->rendered = m_locked;
+    } else {
+        pass->rendered = m_rendered;
+        pass->chars = m_chars;
+    }
+    m_render_dirty = false;
+    m_layout_dirty = false;
+    m_pass = pass;
+    m_watcher.setFuture(QtConcurrent::run(&RebuildScheduler::runPass,pass.data()));
+}
+
+void RebuildScheduler::runPass(Pass* pass) {
+    if (pass->render) {
+        FontRenderer renderer(0,&pass->font);
+        renderer.setCancel(&pass->cancel);
+        RebuildProgress progress(pass,&renderer);
+        connect(&renderer,SIGNAL(rasterized(int,int)),
+                &progress,SLOT(onRasterized(int,int)),Qt::DirectConnection);
+        renderer.open(1.0f);
+        renderer.LoadLocked(pass->rendered);
+        renderer.render(1.0f);
+        if (pass->isCancelled())
+            return;
+        pass->rendered = renderer.data();
+        pass->chars = renderer.rendered();
+        if (progress.published())
+            QMetaObject::invokeMethod(pass->scheduler,"onPartial",Qt::QueuedConnection,
+                                      Q_ARG(int,pass->generation),Q_ARG(int,0),Q_ARG(int,0));
+    }
+    LayouterFactory factory;
+    AbstractLayouter* layouter = factory.build(pass->layout.layouter(),0);
+    if (!layouter)
+        return;
+    layouter->setConfig(&pass->layout);
+    layouter->setData(&pass->data);
+    layouter->on_ReplaceImages(pass->chars);
+    delete layouter;
+    if (pass->isCancelled())
+        return;
+    pass->data.setImage(AbstractImageWriter::buildImage(&pass->data,&pass->layout,pass->rendered));
+}
+
+void RebuildScheduler::onPassFinished() {
+    if (!m_pass || !m_watcher.isFinished())
+        return;
+    QSharedPointer<Pass> pass = m_pass;
+    m_pass.clear();
+    if (pass->generation==m_generation && !pass->isCancelled()) {
+        if (pass->render) {
+            m_rendered = pass->rendered;
+            m_chars = pass->chars;
+            renderFinished();
+        }
+        m_layout_data->resize(pass->data.width(),pass->data.height());
+        m_layout_data->setImage(pass->data.image());
+        m_layout_data->beginPlacing();
+        foreach (const LayoutChar& c, pass->data.placed())
+            m_layout_data->placeChar(c);
+        m_layout_data->endPlacing();
+    } else {
+        qDebug() << "dropped stale pass" << pass->generation;
+    }
+    if ((m_render_dirty || m_layout_dirty) && !m_timer.isActive())
+        start();
+    if (!m_pass && !m_timer.isActive())
+        finished();
+}
+
+/// value and maximum 0 after rendering, while the layouter packs
+void RebuildScheduler::onPartial(int generation,int value,int maximum) {
+    if (!m_pass || m_pass->generation!=generation || m_pass->isCancelled())
+        return;
+    if (maximum) {
+        QMutexLocker lock(&m_pass->partial_mutex);
+        if (m_pass->partial_image.isNull())
+            return;
+        m_rendered = m_pass->partial_rendered;
+        m_layout_data->resize(m_pass->partial_image.width(),m_pass->partial_image.height());
+        m_layout_data->setImage(m_pass->partial_image);
+        m_layout_data->beginPlacing();
+        foreach (const LayoutChar& c, m_pass->partial_placed)
+            m_layout_data->placeChar(c);
+        m_pass->partial_image = QImage();
+        lock.unlock();
+        m_layout_data->endPlacing();
+    }
+    progress(value,maximum);
+}
+
+RebuildProgress::RebuildProgress(RebuildScheduler::Pass* pass,const FontRenderer* renderer) :
+    QObject(0), m_pass(pass), m_renderer(renderer), m_published(false)
+{
+    m_timer.start();
+}
+
+/// called between glyphs, so the renderer state is consistent
+void RebuildProgress::onRasterized(int value,int maximum) {
+    if (m_timer.elapsed()<PublishInterval || m_pass->isCancelled())
+        return;
+    m_timer.restart();
+
+    /// shelves in raster order, offsets added like the layouters do
+    const LayoutConfig& config = m_pass->layout;
+    LayoutData data;
+    data.beginPlacing();
+    int x = 0;
+    int y = 0;
+    int row = 0;
+    int width = 0;
+    foreach (LayoutChar c, m_renderer->rendered()) {
+        c.w += config.offsetLeft()+config.offsetRight();
+        c.h += config.offsetTop()+config.offsetBottom();
+        if (x>0 && x+c.w>m_pass->preview_width) {
+            x = 0;
+            y += row;
+            row = 0;
+        }
+        c.x = x;
+        c.y = y;
+        data.placeChar(c);
+        x += c.w;
+        row = qMax(row,c.h);
+        width = qMax(width,x);
+    }
+    data.resize(width,y+row);
+    const QImage image = AbstractImageWriter::buildImage(&data,&config,m_renderer->data());
+    {
+        QMutexLocker lock(&m_pass->partial_mutex);
+        m_pass->partial_rendered = m_renderer->data();
+        m_pass->partial_placed = data.placed();
+        m_pass->partial_image = image;
+    }
+    m_published = true;
+    QMetaObject::invokeMethod(m_pass->scheduler,"onPartial",Qt::QueuedConnection,
+                              Q_ARG(int,m_pass->generation),Q_ARG(int,value),Q_ARG(int,maximum));
+}
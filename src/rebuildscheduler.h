@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef REBUILDSCHEDULER_H
+#define REBUILDSCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+#include <QTimer>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+
+#include "rendererdata.h"
+#include "layoutchar.h"
+
+class FontConfig;
+class LayoutConfig;
+class LayoutData;
+class FontRenderer;
+
+/// Rebuilds the interactive preview off the GUI thread. Config changes
+/// only mark a stage dirty; changes within one frame are coalesced into
+/// a single render, layout and composite pass on a worker thread. Newer
+/// settings cancel the pass in flight, and results of an older
+/// generation are dropped. Long passes publish the glyphs rasterized so
+/// far, packed in raster order, before the layouter packs the atlas.
+class RebuildScheduler : public QObject
+{
+Q_OBJECT
+    friend class RebuildProgress;
+public:
+    RebuildScheduler(QObject *parent,const FontConfig* font,const LayoutConfig* layout,LayoutData* data);
+    ~RebuildScheduler();
+
+    /// glyphs of the last applied pass
+    const RendererData& data() const { return m_rendered;}
+    const QVector<LayoutChar>& rendered() const { return m_chars;}
+    /// glyphs kept over every render, e.g. from FontLoader or a project
+    void setLocked(const RendererData& locked);
+    /// no pass is running or pending, data() matches the settings
+    bool idle() const { return !m_pass && !m_timer.isActive();}
+signals:
+    void renderFinished();
+    /// glyphs rasterized of all, maximum 0 while packing
+    void progress(int value,int maximum);
+    /// no pass is running or pending
+    void finished();
+public slots:
+    void scheduleRender();
+    void scheduleLayout();
+private:
+    struct Pass;
+    const FontConfig* m_font_config;
+    const LayoutConfig* m_layout_config;
+    LayoutData* m_layout_data;
+    RendererData m_rendered;
+    QVector<LayoutChar> m_chars;
+    RendererData m_locked;
+    QTimer m_timer;
+    bool m_render_dirty;
+    bool m_layout_dirty;
+    int m_generation;
+    QSharedPointer<Pass> m_pass;
+    QFutureWatcher<void> m_watcher;
+
+    void cancelPass();
+    static void runPass(Pass* pass);
+private slots:
+    void start();
+    void onPassFinished();
+    void onPartial(int generation,int value,int maximum);
+};
+
+/// Lives on the worker thread of a pass, snapshots the renderer while
+/// rasterize() runs and hands the snapshot to the scheduler.
+class RebuildProgress : public QObject
+{
+Q_OBJECT
+public:
+    RebuildProgress(RebuildScheduler::Pass* pass,const FontRenderer* renderer);
+    bool published() const { return m_published;}
+public slots:
+    void onRasterized(int value,int maximum);
+private:
+    RebuildScheduler::Pass* m_pass;
+    const FontRenderer* m_renderer;
+    QElapsedTimer m_timer;
+    bool m_published;
+};
+
+#endif // REBUILDSCHEDULER_H
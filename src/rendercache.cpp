@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "rendercache.h"
+#include "fontconfig.h"
+#include "fontrenderer.h"
+
+#include <QDataStream>
+#include <QMetaProperty>
+#include <QMutexLocker>
+
+/// every property the renderer output depends on, plus the scale
+static QByteArray renderKey(const FontConfig* config,float scale) {
+    QByteArray key;
+    QDataStream s(&key,QIODevice::WriteOnly);
+    const QMetaObject *metaobject = config->metaObject();
+    for (int i=0;i<metaobject->propertyCount();i++)
+        s << config->property(metaobject->property(i).name());
+    s << scale;
+    return key;
+}
+
+void RenderCache::reserve(const FontConfig* config,float scale) {
+    const QByteArray key = renderKey(config,scale);
+    QMutexLocker lock(&m_mutex);
+    m_uses[key]++;
+}
+
+void RenderCache::release(const FontConfig* config,float scale) {
+    const QByteArray key = renderKey(config,scale);
+    QMutexLocker lock(&m_mutex);
+    consume(key);
+}
+
+void RenderCache::consume(const QByteArray& key) {
+    QHash<QByteArray,int>::Iterator it = m_uses.find(key);
+    if (it!=m_uses.end() && --it.value()>0)
+        return;
+    if (it!=m_uses.end())
+        m_uses.erase(it);
+    m_entries.remove(key);
+}
+
+QSharedPointer<const RenderCache::Entry> RenderCache::render(const FontConfig* config,float scale) {
+    const QByteArray key = renderKey(config,scale);
+    {
+        QMutexLocker lock(&m_mutex);
+        while (m_pending.contains(key))
+            m_ready.wait(&m_mutex);
+        QSharedPointer<const Entry> entry = m_entries.value(key);
+        if (entry) {
+            m_hits++;
+            consume(key);
+            return entry;
+        }
+        m_pending.insert(key);
+    }
+
+    FontRenderer renderer(0,config);
+    renderer.open(scale);
+    renderer.render(scale);
+    QSharedPointer<Entry> entry(new Entry());
+    entry->data = renderer.data();
+    entry->chars = renderer.rendered();
+
+    QMutexLocker lock(&m_mutex);
+    m_entries.insert(key,entry);
+    m_pending.remove(key);
+    m_renders++;
+    consume(key);
+    m_ready.wakeAll();
+    return entry;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "rendererdata.h"
+#include "layoutchar.h"
+
+class FontConfig;
+
+/// Rendered glyphs shared between export jobs. Jobs whose font configs
+/// are equal render once per scale; a job asking for a render another
+/// thread is doing waits for it instead of rendering again. An entry is
+/// kept only while reserved uses of it remain, so a long manifest holds
+/// the renders its queued jobs still need, not every render it made.
+class RenderCache
+{
+public:
+    struct Entry {
+        RendererData data;
+        QVector<LayoutChar> chars;
+    };
+
+    RenderCache() : m_renders(0),m_hits(0) {}
+
+    /// one later render() of (config, scale), made before jobs are queued
+    void reserve(const FontConfig* config,float scale);
+    /// a reserved use that will not render after all, e.g. a skipped job
+    void release(const FontConfig* config,float scale);
+    /// takes one reserved use, unreserved renders are not kept
+    QSharedPointer<const Entry> render(const FontConfig* config,float scale);
+
+    int renders() const { return m_renders;}
+    int hits() const { return m_hits;}
+private:
+    /// called locked, drops the entry with its last use
+    void consume(const QByteArray& key);
+
+    QMutex m_mutex;
+    QWaitCondition m_ready;
+    QHash<QByteArray,QSharedPointer<const Entry> > m_entries;
+    QSet<QByteArray> m_pending;
+    QHash<QByteArray,int> m_uses;
+    int m_renders;
+    int m_hits;
+};
+
+#endif // RENDERCACHE_H
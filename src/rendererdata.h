@@ -42,18 +42,24 @@ struct RenderedChar {
     int offsetX;
     int offsetY;
     int advance;
+    int advance64;              ///< 26.6, advance is it truncated
     QImage img;
-    QMap<uint,int> kerning;
+    QMap<uint,int> kerning;     ///< grid fitted pixel amounts by second symbol
+    QMap<uint,int> kerning64;   ///< unfitted 26.6 amounts, same keys as kerning
     bool    locked;
     RenderedChar() : symbol(0),locked(false) {}
     RenderedChar(uint symbol,int x,int y,int a,const QImage& img) :
-            symbol(symbol),offsetX(x),offsetY(y),advance(a),img(img) ,locked(false){}
+            symbol(symbol),offsetX(x),offsetY(y),advance(a),advance64(a*64),img(img) ,locked(false){}
 };
 
 struct RenderedMetrics {
     int ascender;
     int descender;
     int height;
+    /// 26.6 values the integer ones are truncated from
+    int ascender64;
+    int descender64;
+    int height64;
 };
 
 struct RendererData {
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "abstractexporter.h"
+#include "exporterfactory.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <cstdio>
+
+namespace {
+    QTextStream& out() {
+        static QTextStream stream(stdout);
+        return stream;
+    }
+
+    int failed = 0;
+
+    struct TempFiles {
+        QStringList files;
+        ~TempFiles() {
+            foreach (const QString& file, files)
+                QFile::remove(file);
+        }
+    };
+}
+
+void Bench::report(const char* bench,const QString& name,qint64 ns,qint64 bytes,qint64 peak_kb) {
+    out() << QString("%1 %2 %3 ms").arg(bench,-10).arg(name,-40).arg(double(ns)/1000000.0,10,'f',3);
+    if (bytes>=0 && ns>0)
+        out() << QString(" %1 MB/s").arg(double(bytes)*1000.0/double(ns),10,'f',1);
+    if (peak_kb>=0)
+        out() << QString(" peak +%1 KiB").arg(peak_kb,8);
+    out() << "\n";
+    out().flush();
+}
+
+void Bench::fail(const char* bench,const QString& name,const QString& why) {
+    out() << QString("%1 %2 FAILED: %3\n").arg(bench,-10).arg(name,-40).arg(why);
+    out().flush();
+    failed++;
+}
+
+int Bench::failures() {
+    return failed;
+}
+
+QString Bench::tempFile(const QString& name) {
+    static TempFiles temp;
+    const QString file = QDir::temp().filePath(QString("fontbuilder_bench_%1_%2")
+                                               .arg(QCoreApplication::applicationPid()).arg(name));
+    if (!temp.files.contains(file))
+        temp.files.push_back(file);
+    return file;
+}
+
+namespace {
+    qint64 baseline_kb = 0;
+
+    /// a "Name:   1234 kB" line of /proc/self/status
+    qint64 statusKb(const char* name) {
+        QFile file("/proc/self/status");
+        if (!file.open(QFile::ReadOnly))
+            return -1;
+        const QByteArray key(name);
+        foreach (const QByteArray& line, file.readAll().split('\n')) {
+            if (line.startsWith(key))
+                return line.mid(key.size()).trimmed().split(' ').first().toLongLong();
+        }
+        return -1;
+    }
+}
+
+void Bench::resetPeakMemory() {
+#ifdef Q_OS_LINUX
+    /// 5 resets the peak resident size to the current one
+    QFile clear("/proc/self/clear_refs");
+    if (clear.open(QFile::WriteOnly))
+        clear.write("5");
+#endif
+    baseline_kb = statusKb("VmRSS:");
+}
+
+qint64 Bench::peakMemory() {
+    const qint64 peak = statusKb("VmHWM:");
+    if (peak<0 || baseline_kb<0)
+        return -1;
+    return qMax(Q_INT64_C(0),peak-baseline_kb);
+}
+
+Bench::Fixture::Fixture(int glyphs,int kerning) {
+    font.setFamily("Bench Sans");
+    font.setStyle("Regular");
+    font.setSize(16);
+
+    rendered.metrics.ascender = 14;
+    rendered.metrics.descender = -4;
+    rendered.metrics.height = 20;
+    rendered.metrics.ascender64 = 14*64+20;
+    rendered.metrics.descender64 = -4*64-10;
+    rendered.metrics.height64 = 20*64+10;
+
+    const int width = 4096;
+    const int row = 18;
+    int x = 0;
+    int y = 0;
+    data.beginPlacing();
+    for (int i=0;i<glyphs;i++) {
+        const uint symbol = code(i);
+        const int w = 8+i%9;
+        const int h = 10+i%7;
+        if (x+w>width) {
+            x = 0;
+            y += row;
+        }
+        data.placeChar(LayoutChar(symbol,x,y,w,h));
+        x += w;
+
+        const int advance = w+1-i%2;
+        RenderedChar rc(symbol,i%3-1,10+i%5,advance,QImage());
+        rc.advance64 = advance*64+(i*5)%64;
+        for (int j=1;j<=kerning && j<glyphs;j++) {
+            const uint second = code((i+j)%glyphs);
+            const int amount64 = -(((i+j)%97)*3+1);
+            rc.kerning64[second] = amount64;
+            rc.kerning[second] = qRound(amount64/64.0);
+        }
+        rendered.chars[symbol] = rc;
+    }
+    data.resize(width,y+row);
+    data.endPlacing();
+}
+
+uint Bench::Fixture::code(int index) {
+    const uint c = 33+uint(index);
+    return c<0x7f ? c : c+0x21;
+}
+
+AbstractExporter* Bench::Fixture::exporter(const QString& format) const {
+    ExporterFactory factory;
+    AbstractExporter* exporter = factory.build(format,0);
+    if (!exporter)
+        return 0;
+    exporter->setFontConfig(&font,&layout);
+    exporter->setData(&data,rendered);
+    exporter->setTextureFilename("atlas.png");
+    return exporter;
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <QString>
+#include <QElapsedTimer>
+
+#include "fontconfig.h"
+#include "layoutconfig.h"
+#include "layoutdata.h"
+#include "rendererdata.h"
+
+class AbstractExporter;
+
+/// Harness shared by the benchmarks. A case is timed as the best of a few
+/// runs, so the numbers show the code rather than the scheduler, and is
+/// checked against a reference so a fast wrong answer fails the run.
+namespace Bench {
+    enum { Runs = 5 };
+
+    /// best wall time of Runs calls of run(), in ns
+    template <class Run>
+    qint64 best(Run& run) {
+        qint64 result = -1;
+        for (int i=0;i<Runs;i++) {
+            QElapsedTimer timer;
+            timer.start();
+            run();
+            const qint64 ns = timer.nsecsElapsed();
+            if (result<0 || ns<result)
+                result = ns;
+        }
+        return result;
+    }
+
+    /// one result line, bytes is the amount of data the case went through
+    /// and peak_kb the memory it grew by, -1 for either leaves it out
+    void report(const char* bench,const QString& name,qint64 ns,qint64 bytes = -1,qint64 peak_kb = -1);
+    /// a case whose result differs from its reference
+    void fail(const char* bench,const QString& name,const QString& why);
+    int failures();
+
+    /// path of a temporary file that is removed at exit
+    QString tempFile(const QString& name);
+
+    /// starts measuring the peak resident size from the current one
+    void resetPeakMemory();
+    /// KiB the resident size peaked above it since resetPeakMemory(),
+    /// -1 where the platform does not tell (only Linux does)
+    qint64 peakMemory();
+
+    /// Synthetic font: glyphs from code 33 up, skipping the C1 controls,
+    /// placed on rows of a 4096 wide atlas, each kerned against the next
+    /// few glyphs with 26.6 amounts, some of which fit to zero pixels.
+    class Fixture {
+    public:
+        Fixture(int glyphs,int kerning);
+
+        static uint code(int index);
+        /// exporter of a format with the fixture tables set, owned by the caller
+        AbstractExporter* exporter(const QString& format) const;
+
+        FontConfig font;
+        LayoutConfig layout;
+        LayoutData data;
+        RendererData rendered;
+    };
+}
+
+#endif // BENCH_H
@@ -0,0 +1,117 @@
+# /**
+# * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+# * email:support.andryblack@gmail.com
+# *
+# * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+# *
+# * This software is distributed under the MIT License.
+# *
+# * Permission is hereby granted, free of charge, to any person
+# * obtaining a copy of this software and associated documentation
+# * files (the "Software"), to deal in the Software without
+# * restriction, including without limitation the rights to use,
+# * copy, modify, merge, publish, distribute, sublicense, and/or sell
+# * copies of the Software, and to permit persons to whom the
+# * Software is furnished to do so, subject to the following
+# * conditions:
+# *
+# * The above copyright notice and this permission notice shall be
+# * included in all copies or substantial portions of the Software.
+# *
+# * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+# * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+# * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+# * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+# * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+# * OTHER DEALINGS IN THE SOFTWARE.
+# */
+# Benchmarks of the export and reload paths, run without arguments for all
+# of them or with the names of the ones to run:
+#   qmake && make && ./fontbuilder_bench [name...]
+# Each benchmark prints one line per case and exits non zero if a result
+# does not match the reference it is compared against.
+TARGET = fontbuilder_bench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+QT += xml
+
+greaterThan(QT_MAJOR_VERSION, 4) {
+    QT += widgets concurrent
+}
+
+SRC = ../../src
+INCLUDEPATH += $$SRC
+
+SOURCES += main.cpp \
+    bench.cpp \
+    tgabench.cpp \
+    xmlbench.cpp \
+    blobbench.cpp \
+    textbench.cpp \
+    roundtripbench.cpp \
+    $$SRC/fontconfig.cpp \
+    $$SRC/layoutconfig.cpp \
+    $$SRC/layoutdata.cpp \
+    $$SRC/perf.cpp \
+    $$SRC/abstractimagewriter.cpp \
+    $$SRC/image/targawriter.cpp \
+    $$SRC/abstractexporter.cpp \
+    $$SRC/kerningclasses.cpp \
+    $$SRC/exporterfactory.cpp \
+    $$SRC/exporters/xmlwriter.cpp \
+    $$SRC/exporters/textwriter.cpp \
+    $$SRC/exporters/ghlexporter.cpp \
+    $$SRC/exporters/zfiexporter.cpp \
+    $$SRC/exporters/divoexporter.cpp \
+    $$SRC/exporters/nglexporter.cpp \
+    $$SRC/exporters/luaexporter.cpp \
+    $$SRC/exporters/sparrowexporter.cpp \
+    $$SRC/exporters/simpleexporter.cpp \
+    $$SRC/exporters/myguiexporter.cpp \
+    $$SRC/exporters/bmfontexporter.cpp \
+    $$SRC/exporters/bmfontbinaryexporter.cpp \
+    $$SRC/exporters/runtimeexporter.cpp \
+    $$SRC/abstractreader.cpp \
+    $$SRC/readerfactory.cpp \
+    $$SRC/readers/ghlreader.cpp \
+    $$SRC/readers/bmfontreader.cpp \
+    $$SRC/readers/simplereader.cpp \
+    $$SRC/readers/zfireader.cpp \
+    $$SRC/readers/luareader.cpp
+
+HEADERS += bench.h \
+    $$SRC/fontconfig.h \
+    $$SRC/layoutconfig.h \
+    $$SRC/layoutdata.h \
+    $$SRC/abstractimagewriter.h \
+    $$SRC/image/targawriter.h \
+    $$SRC/abstractexporter.h \
+    $$SRC/exporterfactory.h \
+    $$SRC/exporters/ghlexporter.h \
+    $$SRC/exporters/zfiexporter.h \
+    $$SRC/exporters/divoexporter.h \
+    $$SRC/exporters/nglexporter.h \
+    $$SRC/exporters/luaexporter.h \
+    $$SRC/exporters/sparrowexporter.h \
+    $$SRC/exporters/simpleexporter.h \
+    $$SRC/exporters/myguiexporter.h \
+    $$SRC/exporters/bmfontexporter.h \
+    $$SRC/exporters/bmfontbinaryexporter.h \
+    $$SRC/exporters/runtimeexporter.h \
+    $$SRC/exporters/fbruntime.h \
+    $$SRC/abstractreader.h \
+    $$SRC/readerfactory.h \
+    $$SRC/readers/ghlreader.h \
+    $$SRC/readers/bmfontreader.h \
+    $$SRC/readers/simplereader.h \
+    $$SRC/readers/zfireader.h \
+    $$SRC/readers/luareader.h
+
+OBJECTS_DIR = .obj
+MOC_DIR = .obj
+
+include(../../freetype.pri)
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "abstractexporter.h"
+#include "abstractreader.h"
+#include "readerfactory.h"
+#include "exporters/fbruntime.h"
+
+#include <QFile>
+
+/// Runtime blob: mapping a blob and looking up every glyph and kerning
+/// pair, against parsing the same font from a BMFont text description.
+namespace {
+    bool writeFile(const QString& file,const QByteArray& data) {
+        QFile f(file);
+        return f.open(QFile::WriteOnly|QFile::Truncate) && f.write(data)==data.size();
+    }
+
+    struct LoadBlob {
+        QString file;
+        const AbstractExporter* tables;
+        qint64 sum;
+        void operator()() {
+            sum = 0;
+            QFile f(file);
+            if (!f.open(QFile::ReadOnly))
+                return;
+            const qint64 size = f.size();
+            uchar* data = f.map(0,size);
+            const fbr_header* h = fbr_open(data,size_t(size));
+            if (!h)
+                return;
+            const AbstractExporter::KerningPair* pairs = tables->kernings().constData();
+            foreach (const AbstractExporter::Symbol& s, tables->symbols()) {
+                const fbr_glyph* g = fbr_find_glyph(h,s.id);
+                if (!g)
+                    continue;
+                sum += g->advance;
+                for (int i=0;i<s.kerningCount;i++) {
+                    const fbr_glyph* second = fbr_find_glyph(h,pairs[s.kerningBegin+i].second);
+                    if (second)
+                        sum += fbr_find_kerning(h,g,second);
+                }
+            }
+            f.unmap(data);
+        }
+    };
+
+    struct ParseText {
+        QString file;
+        AbstractReader* reader;
+        bool ok;
+        void operator()() {
+            QFile f(file);
+            ok = f.open(QFile::ReadOnly) && reader->Read(f.readAll());
+        }
+    };
+
+    /// every glyph and pair of the tables, as the blob answers for them
+    QString verify(const QByteArray& blob,const AbstractExporter* tables) {
+        /// QByteArray data is aligned for any scalar
+        const fbr_header* h = fbr_open(blob.constData(),size_t(blob.size()));
+        if (!h)
+            return "fbr_open rejects the blob";
+        const AbstractExporter::KerningPair* pairs = tables->kernings().constData();
+        foreach (const AbstractExporter::Symbol& s, tables->symbols()) {
+            const fbr_glyph* g = fbr_find_glyph(h,s.id);
+            if (!g)
+                return QString("glyph %1 missing").arg(s.id);
+            if (g->x!=s.placeX || g->y!=s.placeY || g->w!=s.placeW || g->h!=s.placeH ||
+                    g->offset_x!=s.offsetX || g->offset_y!=s.offsetY || g->advance!=s.advance64)
+                return QString("glyph %1 differs").arg(s.id);
+            for (int i=0;i<s.kerningCount;i++) {
+                const AbstractExporter::KerningPair& k = pairs[s.kerningBegin+i];
+                const fbr_glyph* second = fbr_find_glyph(h,k.second);
+                if (!second || fbr_find_kerning(h,g,second)!=k.amount64)
+                    return QString("kerning %1 %2 differs").arg(k.first).arg(k.second);
+            }
+        }
+        if (fbr_find_glyph(h,1))
+            return "glyph 1 found though it is not in the font";
+        return QString();
+    }
+
+    void blobCase(const Bench::Fixture& fixture,bool classes) {
+        const QString name = classes ? "blob, kerning classes" : "blob, kerning pairs";
+        AbstractExporter* exporter = fixture.exporter("Runtime blob (FBR)");
+        exporter->setKerningClasses(classes);
+        QByteArray blob;
+        if (!exporter->Write(blob)) {
+            Bench::fail("blob",name,exporter->getErrorString());
+            delete exporter;
+            return;
+        }
+        const QString error = verify(blob,exporter);
+        if (!error.isEmpty())
+            Bench::fail("blob",name,error);
+        LoadBlob load;
+        load.file = Bench::tempFile(classes ? "classes.fbr" : "pairs.fbr");
+        load.tables = exporter;
+        if (!writeFile(load.file,blob))
+            Bench::fail("blob",name,"can not write "+load.file);
+        else
+            Bench::report("blob",name,Bench::best(load),blob.size());
+        delete exporter;
+    }
+}
+
+void BlobBench() {
+    const Bench::Fixture fixture(30000,8);
+    blobCase(fixture,false);
+    blobCase(fixture,true);
+
+    AbstractExporter* exporter = fixture.exporter("BMFont");
+    QByteArray text;
+    ParseText parse;
+    parse.file = Bench::tempFile("font.fnt");
+    ReaderFactory factory;
+    parse.reader = factory.build("BMFont",0);
+    if (!exporter->Write(text) || !writeFile(parse.file,text)) {
+        Bench::fail("blob","BMFont text parse","can not write "+parse.file);
+    } else {
+        const qint64 ns = Bench::best(parse);
+        if (!parse.ok)
+            Bench::fail("blob","BMFont text parse",parse.reader->errorString());
+        Bench::report("blob","BMFont text parse",ns,text.size());
+    }
+    delete parse.reader;
+    delete exporter;
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <cstdio>
+#include <cstring>
+
+extern void TgaBench();
+extern void XmlBench();
+extern void BlobBench();
+extern void TextBench();
+extern void RoundTripBench();
+
+namespace {
+    struct Entry {
+        const char* name;
+        void (*run)();
+    };
+
+    const Entry benches[] = {
+        { "tga", &TgaBench },
+        { "xml", &XmlBench },
+        { "blob", &BlobBench },
+        { "text", &TextBench },
+        { "roundtrip", &RoundTripBench }
+    };
+    const int bench_count = int(sizeof(benches)/sizeof(benches[0]));
+
+    /// decoders and writers log every call, which would drown the results
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    void quiet(QtMsgType type,const QMessageLogContext&,const QString& msg) {
+        if (type!=QtDebugMsg)
+            fprintf(stderr,"%s\n",msg.toLocal8Bit().constData());
+    }
+#else
+    void quiet(QtMsgType type,const char* msg) {
+        if (type!=QtDebugMsg)
+            fprintf(stderr,"%s\n",msg);
+    }
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc,argv);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    qInstallMessageHandler(quiet);
+#else
+    qInstallMsgHandler(quiet);
+#endif
+    QStringList selected = app.arguments().mid(1);
+    foreach (const QString& name, selected) {
+        bool known = false;
+        for (int i=0;i<bench_count;i++)
+            known = known || name==benches[i].name;
+        if (!known) {
+            fprintf(stderr,"unknown benchmark %s, known:",name.toLocal8Bit().constData());
+            for (int i=0;i<bench_count;i++)
+                fprintf(stderr," %s",benches[i].name);
+            fprintf(stderr,"\n");
+            return 2;
+        }
+    }
+    for (int i=0;i<bench_count;i++) {
+        if (selected.isEmpty() || selected.contains(benches[i].name))
+            benches[i].run();
+    }
+    return Bench::failures() ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "abstractexporter.h"
+#include "abstractreader.h"
+#include "readerfactory.h"
+
+/// Round trip of every format a reader exists for: the fixture is exported,
+/// parsed back and compared with the tables it was written from, and the
+/// parse is timed.
+namespace {
+    struct Parse {
+        AbstractReader* reader;
+        const QByteArray* data;
+        bool ok;
+        void operator()() {
+            ok = reader->Read(*data);
+        }
+    };
+}
+
+void RoundTripBench() {
+    const Bench::Fixture fixture(30000,8);
+    ReaderFactory factory;
+    foreach (const QString& format, factory.names()) {
+        AbstractExporter* exporter = fixture.exporter(format);
+        if (!exporter) {
+            Bench::fail("roundtrip",format,"no such exporter");
+            continue;
+        }
+        QByteArray data;
+        if (!exporter->Write(data)) {
+            Bench::fail("roundtrip",format,exporter->getErrorString());
+            delete exporter;
+            continue;
+        }
+        Parse parse;
+        parse.reader = factory.build(format,0);
+        parse.data = &data;
+        const qint64 ns = Bench::best(parse);
+        if (!parse.ok) {
+            Bench::fail("roundtrip",format,parse.reader->errorString());
+        } else {
+            const QStringList errors = parse.reader->compare(exporter->symbols(),exporter->pixelKernings());
+            if (!errors.isEmpty())
+                Bench::fail("roundtrip",format,errors.first());
+        }
+        Bench::report("roundtrip",format,ns,data.size());
+        delete parse.reader;
+        delete exporter;
+    }
+}
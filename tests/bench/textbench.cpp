@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "abstractexporter.h"
+
+#include <QStringList>
+
+/// Text descriptions: the TextWriter exporters on a 30k glyph font, and
+/// the Simple format as it was written before, through QString::number.
+namespace {
+    QByteArray stringSimple(const Bench::Fixture& fixture,const AbstractExporter* tables) {
+        QByteArray out;
+        const int height = fixture.rendered.metrics.height + fixture.font.lineSpacing();
+        out.append(fixture.font.family().toUtf8()).append('\n');
+        out.append(QString::number(fixture.font.size()).toUtf8()).append(' ');
+        out.append(QString::number(height).toUtf8()).append('\n');
+        out.append(QString("atlas.png").toUtf8()).append('\n');
+        out.append(QString::number(tables->symbols().size()).toUtf8()).append('\n');
+        foreach(const AbstractExporter::Symbol& c , tables->symbols()) {
+            out.append(QString::number(c.id).toUtf8()).append(' ');
+            out.append(QString::number(c.placeX).toUtf8()).append(' ');
+            out.append(QString::number(c.placeY).toUtf8()).append(' ');
+            out.append(QString::number(c.placeW).toUtf8()).append(' ');
+            out.append(QString::number(c.placeH).toUtf8()).append(' ');
+            out.append(QString::number(c.offsetX).toUtf8()).append(' ');
+            out.append(QString::number(height - c.offsetY).toUtf8()).append(' ');
+            out.append(QString::number(c.advance).toUtf8()).append(' ');
+            out.append('\n');
+        }
+        QByteArray kernings;
+        int kerningsCount = 0;
+        foreach(const AbstractExporter::KerningPair& k , tables->pixelKernings()) {
+            kernings.append(QString::number(k.first).toUtf8()).append(' ');
+            kernings.append(QString::number(k.second).toUtf8()).append(' ');
+            kernings.append(QString::number(k.amount).toUtf8()).append(' ');
+            kernings.append('\n');
+            ++kerningsCount;
+        }
+        out.append(QString::number(kerningsCount).toUtf8()).append('\n');
+        out.append(kernings);
+        return out;
+    }
+
+    struct Write {
+        AbstractExporter* exporter;
+        QByteArray out;
+        void operator()() {
+            out.clear();
+            exporter->Write(out);
+        }
+    };
+
+    struct Strings {
+        const Bench::Fixture* fixture;
+        const AbstractExporter* tables;
+        QByteArray out;
+        void operator()() {
+            out = stringSimple(*fixture,tables);
+        }
+    };
+}
+
+void TextBench() {
+    const Bench::Fixture fixture(30000,8);
+    const QStringList formats = QStringList() << "Simple" << "BMFont" << "Lua table" << "Lua function";
+    foreach (const QString& format, formats) {
+        Write write;
+        write.exporter = fixture.exporter(format);
+        if (!write.exporter) {
+            Bench::fail("text",format,"no such exporter");
+            continue;
+        }
+        Bench::report("text",format,Bench::best(write),write.out.size());
+        if (write.out.isEmpty())
+            Bench::fail("text",format,write.exporter->getErrorString());
+
+        if (format=="Simple") {
+            Strings strings;
+            strings.fixture = &fixture;
+            strings.tables = write.exporter;
+            Bench::report("text","Simple (QString::number)",Bench::best(strings),strings.out.size());
+            if (strings.out!=write.out)
+                Bench::fail("text","Simple","output differs from the QString::number one");
+        }
+        delete write.exporter;
+    }
+}
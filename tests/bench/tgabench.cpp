@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "image/targawriter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QVector>
+#include <cstring>
+
+/// TGA reload: the mapped, bounds checked decoder against the one it
+/// replaced, on the raw file the writer produces and on an RLE file.
+namespace {
+    /// glyph like content: transparent gaps around cells of varying coverage
+    QImage makeAtlas(int width,int height) {
+        QImage image(width,height,QImage::Format_ARGB32);
+        for (int y=0;y<height;y++) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x=0;x<width;x++) {
+                const bool glyph = (x%24)<18 && (y%28)<22 && ((x/24+y/28)%5)!=0;
+                const int alpha = glyph ? ((x*7+y*13)%23<9 ? 255 : (x*3+y)%256) : 0;
+                line[x] = qRgba(255,255,255,alpha);
+            }
+        }
+        return image;
+    }
+
+    void putU16(QByteArray& out,int v) {
+        out.append(char(v&0xff));
+        out.append(char((v>>8)&0xff));
+    }
+
+    /// 32bpp RLE stored bottom up, so a decoder has to flip it
+    QByteArray encodeRle(const QImage& image) {
+        QByteArray out;
+        out.append(char(0));        // id length
+        out.append(char(0));        // no colour map
+        out.append(char(10));       // RLE true colour
+        out.append(QByteArray(5,0));
+        putU16(out,0);
+        putU16(out,0);
+        putU16(out,image.width());
+        putU16(out,image.height());
+        out.append(char(32));
+        out.append(char(8));        // 8 alpha bits, bottom up
+        QVector<QRgb> pixels;
+        pixels.reserve(image.width()*image.height());
+        for (int y=image.height()-1;y>=0;y--) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+            for (int x=0;x<image.width();x++)
+                pixels.push_back(line[x]);
+        }
+        int i = 0;
+        while (i<pixels.size()) {
+            int run = 1;
+            while (i+run<pixels.size() && run<128 && pixels[i+run]==pixels[i])
+                run++;
+            if (run>1) {
+                out.append(char(127+run));
+                out.append(reinterpret_cast<const char*>(&pixels[i]),4);
+                i+=run;
+                continue;
+            }
+            int raw = 1;
+            while (i+raw<pixels.size() && raw<128 &&
+                   !(i+raw+1<pixels.size() && pixels[i+raw]==pixels[i+raw+1]))
+                raw++;
+            out.append(char(raw-1));
+            out.append(reinterpret_cast<const char*>(&pixels[i]),raw*4);
+            i+=raw;
+        }
+        return out;
+    }
+
+    /// the decoder before the rewrite, header fields read by offset
+    /// instead of through the packed struct
+    template <int bpp>
+    inline uchar* copy_element(const uchar* src,uchar* dst) {
+        for (int i=0;i<bpp;i++)
+            *dst++=*src++;
+        return dst;
+    }
+
+    template <int bpp>
+    void legacy_rle(uchar* data,QFile& file,int size) {
+        uchar c;
+        while (size>0) {
+            if (file.read(reinterpret_cast<char*>(&c),1)!=1) return;
+            if (c < 128) {
+                c++;
+                file.read(reinterpret_cast<char*>(data), bpp * c);
+                data+=bpp * c;
+                size-= c;
+            } else {
+                c-=127;
+                file.read(reinterpret_cast<char*>(data), bpp);
+                uchar* out = data + bpp;
+                for(uint counter = 1; counter < c; counter++)
+                {
+                    out = copy_element<bpp>(data,out);
+                }
+                data = out;
+                size-= c;
+            }
+        }
+    }
+
+    QImage* legacyReload(QFile& file) {
+        uchar header[18];
+        if (file.read(reinterpret_cast<char*>(header),18)!=18)
+            return 0;
+        if (header[1])
+            return 0;
+        bool rle = header[2] & 8;
+        if ( (header[2]&7) != 2)
+            return 0;
+        int bpp = header[16];
+        if (bpp!=24 && bpp!=32)
+            return 0;
+        int width = header[12] | (header[13]<<8);
+        int height = header[14] | (header[15]<<8);
+        QImage* img = new QImage(width,height,QImage::Format_ARGB32);
+        img->fill(0);
+        uchar* data = reinterpret_cast<uchar*>(img->bits());
+        if (bpp==32) {
+            if (!rle)
+                file.read(reinterpret_cast<char*>(data),width*height*4);
+            else
+                legacy_rle<4>(data,file,width*height);
+        } else {
+            uchar* src = new uchar [ width * height * 3];
+            if (!rle)
+                file.read(reinterpret_cast<char*>(src),width*height*3);
+            else
+                legacy_rle<3>(src,file,width*height);
+            const uchar* s = src;
+            uchar* d = data;
+            for (int i=0;i<width*height;i++) {
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = 255;
+            }
+            delete [] src;
+        }
+        const int line_len = width*4;
+        if ((header[17] & (1<<5))==0) {
+            QVector<uchar> line(line_len);
+            for (int i=0;i<height/2;i++) {
+                ::memcpy(line.data(),data+line_len*i,line_len);
+                ::memcpy(data+line_len*i,data+line_len*(height-1-i),line_len);
+                ::memcpy(data+line_len*(height-1-i),line.data(),line_len);
+            }
+        }
+        return img;
+    }
+
+    struct Reload {
+        QString file;
+        bool legacy;
+        TargaImageWriter writer;
+        QImage result;
+        Reload(const QString& file,bool legacy) : file(file),legacy(legacy),writer("tga") {}
+        void operator()() {
+            QFile f(file);
+            if (!f.open(QFile::ReadOnly)) {
+                result = QImage();
+                return;
+            }
+            QImage* image = legacy ? legacyReload(f) : writer.Read(f);
+            result = image ? *image : QImage();
+            delete image;
+        }
+    };
+
+    void runCase(const QString& name,const QString& file,const QImage& reference) {
+        const qint64 size = QFileInfo(file).size();
+        Reload current(file,false);
+        Reload legacy(file,true);
+        const qint64 current_ns = Bench::best(current);
+        const qint64 legacy_ns = Bench::best(legacy);
+        if (current.result!=reference)
+            Bench::fail("tga",name,"decoded image differs from the atlas");
+        else if (legacy.result!=reference)
+            Bench::fail("tga",name+" (old)","decoded image differs from the atlas");
+        Bench::report("tga",name,current_ns,size);
+        Bench::report("tga",name+" (old)",legacy_ns,size);
+    }
+}
+
+void TgaBench() {
+    const QImage atlas = makeAtlas(2048,2048);
+
+    const QString raw = Bench::tempFile("raw.tga");
+    {
+        QFile file(raw);
+        TargaImageWriter writer("tga");
+        if (!file.open(QFile::ReadWrite|QFile::Truncate) || !writer.Write(file,AtlasView(atlas))) {
+            Bench::fail("tga","raw 32bpp","can not write "+raw);
+            return;
+        }
+    }
+    runCase("raw 32bpp 2048x2048",raw,atlas);
+
+    const QString rle = Bench::tempFile("rle.tga");
+    {
+        QFile file(rle);
+        const QByteArray data = encodeRle(atlas);
+        if (!file.open(QFile::WriteOnly|QFile::Truncate) || file.write(data)!=data.size()) {
+            Bench::fail("tga","rle 32bpp","can not write "+rle);
+            return;
+        }
+    }
+    runCase("rle 32bpp bottom up 2048x2048",rle,atlas);
+}
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2010-2010 Andrey AndryBlack Kunitsyn
+ * email:support.andryblack@gmail.com
+ *
+ * Report bugs and download new versions at http://code.google.com/p/fontbuilder
+ *
+ * This software is distributed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bench.h"
+#include "abstractexporter.h"
+
+#include <QDomDocument>
+#include <QStringList>
+
+/// XML descriptions: write time and memory of the streaming exporters on a
+/// large font, against the DOM build they replaced.
+namespace {
+    /// the Sparrow exporter as it was, building a QDomDocument
+    QByteArray domSparrow(const Bench::Fixture& fixture,const AbstractExporter* tables) {
+        QDomDocument doc;
+        QDomElement root = doc.createElement("font");
+        doc.appendChild(root);
+        QDomElement info = doc.createElement("info");
+        root.appendChild(info);
+        info.setAttribute("face", fixture.font.family());
+        info.setAttribute("size", fixture.font.size());
+        QDomElement common = doc.createElement("common");
+        root.appendChild(common);
+        const int height = fixture.rendered.metrics.height + fixture.font.lineSpacing();
+        common.setAttribute("lineHeight", height);
+        QDomElement pages = doc.createElement("pages");
+        root.appendChild(pages);
+        QDomElement page = doc.createElement("page");
+        pages.appendChild(page);
+        page.setAttribute("id", "0");
+        page.setAttribute("file", "atlas.png");
+        QDomElement chars = doc.createElement("chars");
+        root.appendChild(chars);
+        chars.setAttribute("count", tables->symbols().size());
+        foreach(const AbstractExporter::Symbol& c , tables->symbols()) {
+            QDomElement ch = doc.createElement("char");
+            ch.setAttribute("id", QString::number(c.id));
+            ch.setAttribute("x", QString::number(c.placeX));
+            ch.setAttribute("y", QString::number(c.placeY));
+            ch.setAttribute("width", QString::number(c.placeW));
+            ch.setAttribute("height", QString::number(c.placeH));
+            ch.setAttribute("xoffset", QString::number(c.offsetX));
+            ch.setAttribute("yoffset", QString::number(height - c.offsetY));
+            ch.setAttribute("xadvance", QString::number(c.advance));
+            ch.setAttribute("page", "0");
+            ch.setAttribute("chnl", "0");
+            ch.setAttribute("letter", c.id==32 ? QString("space") : QString().append(QChar(c.id)));
+            chars.appendChild(ch);
+        }
+        QDomElement kernings = doc.createElement("kernings");
+        const QVector<AbstractExporter::KerningPair> pairs = tables->pixelKernings();
+        foreach(const AbstractExporter::KerningPair& k , pairs) {
+            QDomElement ker = doc.createElement("kerning");
+            ker.setAttribute("first", QString::number(k.first));
+            ker.setAttribute("second", QString::number(k.second));
+            ker.setAttribute("amount", k.amount);
+            kernings.appendChild(ker);
+        }
+        kernings.setAttribute("count", QString::number(pairs.size()));
+        root.appendChild(kernings);
+        return doc.toByteArray(1);
+    }
+
+    struct Stream {
+        AbstractExporter* exporter;
+        QByteArray out;
+        void operator()() {
+            out.clear();
+            out.squeeze();
+            exporter->Write(out);
+        }
+    };
+
+    struct Dom {
+        const Bench::Fixture* fixture;
+        const AbstractExporter* tables;
+        QByteArray out;
+        void operator()() {
+            out.clear();
+            out.squeeze();
+            out = domSparrow(*fixture,tables);
+        }
+    };
+
+    bool parse(const QByteArray& xml,QDomDocument& doc,QString* error) {
+        int line = 0;
+        if (!doc.setContent(xml,error,&line)) {
+            *error = QString("line %1: %2").arg(line).arg(*error);
+            return false;
+        }
+        return true;
+    }
+
+    /// first difference of the two subtrees, empty if there is none;
+    /// attributes are compared as sets, only their order may differ
+    QString compare(const QDomElement& a,const QDomElement& b) {
+        if (a.tagName()!=b.tagName())
+            return QString("<%1> against <%2>").arg(a.tagName(),b.tagName());
+        const QDomNamedNodeMap attributes = a.attributes();
+        if (attributes.count()!=b.attributes().count())
+            return QString("<%1> has %2 attributes against %3").arg(a.tagName())
+                    .arg(attributes.count()).arg(b.attributes().count());
+        for (int i=0;i<attributes.count();i++) {
+            const QDomAttr attr = attributes.item(i).toAttr();
+            if (!b.hasAttribute(attr.name()) || b.attribute(attr.name())!=attr.value())
+                return QString("<%1 %2=\"%3\"> against \"%4\"").arg(a.tagName(),attr.name(),
+                        attr.value(),b.attribute(attr.name()));
+        }
+        QDomElement ca = a.firstChildElement();
+        QDomElement cb = b.firstChildElement();
+        if (ca.isNull() && cb.isNull() && a.text()!=b.text())
+            return QString("<%1> text \"%2\" against \"%3\"").arg(a.tagName(),a.text(),b.text());
+        for (;!ca.isNull() && !cb.isNull();ca = ca.nextSiblingElement(),cb = cb.nextSiblingElement()) {
+            const QString diff = compare(ca,cb);
+            if (!diff.isEmpty())
+                return diff;
+        }
+        if (!ca.isNull() || !cb.isNull())
+            return QString("<%1> has a different number of children").arg(a.tagName());
+        return QString();
+    }
+}
+
+void XmlBench() {
+    const Bench::Fixture fixture(30000,8);
+    const QStringList formats = QStringList() << "Sparrow" << "GHL" << "NGL" << "Divo compatible - xml";
+    foreach (const QString& format, formats) {
+        Stream stream;
+        stream.exporter = fixture.exporter(format);
+        if (!stream.exporter) {
+            Bench::fail("xml",format,"no such exporter");
+            continue;
+        }
+        Bench::resetPeakMemory();
+        const qint64 ns = Bench::best(stream);
+        const qint64 peak = Bench::peakMemory();
+        QString error;
+        QDomDocument doc;
+        /// one element per glyph, Divo capitalizes its tags
+        if (!parse(stream.out,doc,&error)) {
+            Bench::fail("xml",format,"not well formed, "+error);
+        } else {
+            const int chars = doc.elementsByTagName(format.startsWith("Divo") ? "Char" : "char").size();
+            if (chars!=fixture.data.placed().size())
+                Bench::fail("xml",format,QString("%1 chars of %2").arg(chars).arg(fixture.data.placed().size()));
+        }
+        Bench::report("xml",format,ns,stream.out.size(),peak);
+
+        if (format=="Sparrow") {
+            Dom dom;
+            dom.fixture = &fixture;
+            dom.tables = stream.exporter;
+            Bench::resetPeakMemory();
+            const qint64 dom_ns = Bench::best(dom);
+            const qint64 dom_peak = Bench::peakMemory();
+            /// the same document as the DOM build wrote, up to attribute order
+            QDomDocument dom_doc;
+            if (!parse(dom.out,dom_doc,&error))
+                Bench::fail("xml","Sparrow (DOM)","not well formed, "+error);
+            else if (!doc.documentElement().isNull()) {
+                const QString diff = compare(doc.documentElement(),dom_doc.documentElement());
+                if (!diff.isEmpty())
+                    Bench::fail("xml","Sparrow","differs from the DOM output, "+diff);
+            }
+            Bench::report("xml","Sparrow (DOM)",dom_ns,dom.out.size(),dom_peak);
+        }
+        delete stream.exporter;
+    }
+}